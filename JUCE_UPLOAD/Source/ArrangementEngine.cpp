@@ -0,0 +1,294 @@
+#include "ArrangementEngine.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+    // Note count plus up to six notes, one byte each
+    juce::uint64 getChordKey(const ChordNotes& chord)
+    {
+        auto key = static_cast<juce::uint64>(chord.size());
+
+        for (int i = 0; i < chord.size(); ++i)
+            key |= static_cast<juce::uint64>(chord.notes[static_cast<size_t>(i)]) << (8 * (i + 1));
+
+        return key;
+    }
+}
+
+//==============================================================================
+ArrangementEngine::ArrangementEngine()
+{
+}
+
+void ArrangementEngine::clear()
+{
+    chords.clear();
+    events.clear();
+    sections.clear();
+    passes.clear();
+    numBars = 0;
+    lengthSeconds = 0.0;
+}
+
+void ArrangementEngine::compile(const std::vector<ArrangementSection>& song)
+{
+    clear();
+
+    std::unordered_map<juce::uint64, int> chordPool;
+    sections.reserve(song.size());
+
+    for (const auto& source : song)
+    {
+        Section section;
+        section.firstEvent = static_cast<int>(events.size());
+        section.beatsPerBar = juce::jlimit(1, 32, source.beatsPerBar);
+        section.beatUnit = juce::jlimit(1, 32, source.beatUnit);
+        section.secondsPerBeat = 60.0 / juce::jlimit(20.0, 300.0, source.bpm);
+
+        double beat = 0.0;
+        for (const auto& step : source.steps)
+        {
+            const auto pooled = chordPool.emplace(getChordKey(step.notes), static_cast<int>(chords.size()));
+            if (pooled.second)
+                chords.push_back(step.notes);
+
+            events.push_back({ beat, pooled.first->second });
+            beat += juce::jmax(1.0 / 16.0, step.beats);
+        }
+
+        const int fittedBars = static_cast<int>(std::ceil(beat / section.beatsPerBar));
+        section.numBars = juce::jmax(1, source.bars > 0 ? source.bars : fittedBars);
+
+        // settings.bars cuts off chords that would start after the section ends
+        const double sectionBeats = section.numBars * section.beatsPerBar;
+        while (static_cast<int>(events.size()) > section.firstEvent && events.back().beat >= sectionBeats)
+            events.pop_back();
+
+        section.numEvents = static_cast<int>(events.size()) - section.firstEvent;
+        sections.push_back(section);
+    }
+
+    for (size_t index = 0; index < song.size(); ++index)
+    {
+        const auto& section = sections[index];
+        const double passSeconds = section.numBars * section.beatsPerBar * section.secondsPerBeat;
+
+        for (int repeat = 0; repeat < juce::jmax(1, song[index].repeat); ++repeat)
+        {
+            passes.push_back({ static_cast<int>(index), numBars, lengthSeconds });
+            numBars += section.numBars;
+            lengthSeconds += passSeconds;
+        }
+    }
+}
+
+int ArrangementEngine::findPass(int bar) const
+{
+    jassert(!passes.empty());
+
+    // Last pass starting at or before the bar
+    const auto next = std::upper_bound(passes.begin(), passes.end(), bar,
+                                       [] (int b, const Pass& p) { return b < p.firstBar; });
+
+    return juce::jmax(0, static_cast<int>(std::distance(passes.begin(), next)) - 1);
+}
+
+const ArrangementEngine::Section& ArrangementEngine::getSectionForPass(int passIndex) const
+{
+    return sections[static_cast<size_t>(passes[static_cast<size_t>(passIndex)].section)];
+}
+
+double ArrangementEngine::getEventSeconds(int passIndex, int eventIndex) const
+{
+    return passes[static_cast<size_t>(passIndex)].startSeconds
+         + events[static_cast<size_t>(eventIndex)].beat * getSectionForPass(passIndex).secondsPerBeat;
+}
+
+double ArrangementEngine::getPassEndSeconds(int passIndex) const
+{
+    const auto& section = getSectionForPass(passIndex);
+    return passes[static_cast<size_t>(passIndex)].startSeconds
+         + section.numBars * section.beatsPerBar * section.secondsPerBeat;
+}
+
+double ArrangementEngine::getBarStartSeconds(int bar) const
+{
+    return locateBar(bar).seconds;
+}
+
+ArrangementEngine::Location ArrangementEngine::locateBar(int bar) const
+{
+    Location location;
+
+    if (passes.empty())
+        return location;
+
+    if (bar >= numBars)
+    {
+        // The end of the song: nothing sounding and nothing left to play
+        location.pass = static_cast<int>(passes.size()) - 1;
+        const auto& section = getSectionForPass(location.pass);
+        location.event = section.firstEvent + section.numEvents;
+        location.seconds = lengthSeconds;
+        return location;
+    }
+
+    location.pass = findPass(juce::jmax(0, bar));
+
+    const auto& pass = passes[static_cast<size_t>(location.pass)];
+    const auto& section = sections[static_cast<size_t>(pass.section)];
+    const double beat = (juce::jmax(0, bar) - pass.firstBar) * section.beatsPerBar;
+
+    const auto first = events.begin() + section.firstEvent;
+    const auto last = first + section.numEvents;
+    const auto next = std::upper_bound(first, last, beat,
+                                       [] (double b, const Event& e) { return b < e.beat; });
+
+    location.sounding = next != first;
+    location.event = static_cast<int>(std::distance(events.begin(), next)) - (location.sounding ? 1 : 0);
+    location.seconds = pass.startSeconds + beat * section.secondsPerBeat;
+    return location;
+}
+
+//==============================================================================
+ArrangementPlayer::ArrangementPlayer()
+{
+}
+
+void ArrangementPlayer::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    stop();
+}
+
+void ArrangementPlayer::setArrangement(const ArrangementEngine* newArrangement)
+{
+    arrangement = newArrangement;
+    looping = false;
+    stop();
+}
+
+void ArrangementPlayer::setLoop(int startBar, int endBar)
+{
+    if (arrangement == nullptr || endBar <= startBar || startBar >= arrangement->getNumBars())
+    {
+        clearLoop();
+        return;
+    }
+
+    looping = true;
+    loopStartBar = juce::jmax(0, startBar);
+    loopEndSamples = arrangement->getBarStartSeconds(endBar) * sampleRate;
+}
+
+void ArrangementPlayer::clearLoop()
+{
+    looping = false;
+}
+
+void ArrangementPlayer::seekToBar(int bar)
+{
+    if (arrangement == nullptr || arrangement->getPasses().empty())
+    {
+        positionSamples = 0.0;
+        pass = 0;
+        nextEvent = 0;
+        eventDueNow = false;
+        return;
+    }
+
+    const auto location = arrangement->locateBar(bar);
+    pass = location.pass;
+    nextEvent = location.event;
+    eventDueNow = location.sounding;
+    positionSamples = location.seconds * sampleRate;
+}
+
+void ArrangementPlayer::start()
+{
+    // Play from wherever the last seek left off, so a song can start from any bar
+    playing = arrangement != nullptr && !arrangement->getPasses().empty();
+}
+
+void ArrangementPlayer::stop()
+{
+    playing = false;
+}
+
+double ArrangementPlayer::getNextEventSamples() const
+{
+    if (eventDueNow)
+        return positionSamples;
+
+    const auto& section = arrangement->getSectionForPass(pass);
+    if (nextEvent < section.firstEvent + section.numEvents)
+        return arrangement->getEventSeconds(pass, nextEvent) * sampleRate;
+
+    // The pass is used up; the next step moves on to the next pass or ends the song
+    return arrangement->getPassEndSeconds(pass) * sampleRate;
+}
+
+double ArrangementPlayer::getNextStepSamples() const
+{
+    const double nextEventSamples = getNextEventSamples();
+    return looping ? juce::jmin(nextEventSamples, loopEndSamples) : nextEventSamples;
+}
+
+int ArrangementPlayer::getSamplesUntilNextStep() const
+{
+    if (!playing)
+        return INT_MAX;
+
+    return juce::jmax(0, static_cast<int>(std::ceil(getNextStepSamples() - positionSamples)));
+}
+
+void ArrangementPlayer::advance(int numSamples)
+{
+    if (playing)
+        positionSamples += numSamples;
+}
+
+ArrangementPlayer::Step ArrangementPlayer::takeStep()
+{
+    jassert(isStepDue());
+
+    Step step;
+
+    if (!eventDueNow && looping && positionSamples >= loopEndSamples)
+    {
+        seekToBar(loopStartBar);
+        step.looped = true;
+
+        // Nothing sounding at the loop start: just the jump
+        if (!eventDueNow)
+        {
+            step.pass = pass;
+            return step;
+        }
+    }
+
+    step.pass = pass;
+    const auto& section = arrangement->getSectionForPass(pass);
+
+    if (eventDueNow || nextEvent < section.firstEvent + section.numEvents)
+    {
+        eventDueNow = false;
+        step.chordIndex = arrangement->getEvents()[static_cast<size_t>(nextEvent++)].chordIndex;
+        return step;
+    }
+
+    if (pass + 1 < static_cast<int>(arrangement->getPasses().size()))
+    {
+        ++pass;
+        nextEvent = arrangement->getSectionForPass(pass).firstEvent;
+        step.pass = pass;
+        return step;
+    }
+
+    stop();
+    step.finished = true;
+    return step;
+}
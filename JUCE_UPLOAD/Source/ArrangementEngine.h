@@ -0,0 +1,174 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "ChordTable.h"
+
+//==============================================================================
+/*
+    Song playback for the Song/Section/ChordProgression types in music.ts, which
+    so far only had the linear playProgression() loop over chordNotes[][].
+
+    ArrangementEngine compiles a song on the message thread. Each section's
+    chords become one sorted run of events, and identical chords are shared
+    through a single chord pool. Repeats are not unrolled: every pass through
+    a section gets one small entry holding its first bar and start time, and
+    those entries form the tempo and time-signature map. Memory therefore grows
+    with unique events, not with song length.
+
+    Finding the pass that holds a bar and then the chord sounding at a beat are
+    both binary searches, so seeking is O(log n).
+
+    ArrangementPlayer walks a compiled arrangement against the sample clock,
+    like ProgressionSequencer. Seeking, looping and stepping never allocate, and
+    changing the loop region doesn't recompile anything.
+*/
+struct ArrangementStep
+{
+    ChordNotes notes;
+    double beats = 4.0;                 // ChordModifier.duration
+};
+
+struct ArrangementSection
+{
+    juce::String name;                  // 'Verse', 'Chorus', ...
+    std::vector<ArrangementStep> steps;
+    int repeat = 1;
+    double bpm = 120.0;                 // beats of beatUnit per minute
+    int bars = 0;                       // settings.bars; 0 fits the steps
+    int beatsPerBar = 4;                // TimeSignature
+    int beatUnit = 4;
+};
+
+class ArrangementEngine
+{
+public:
+    struct Event
+    {
+        double beat = 0.0;              // from the start of the section
+        int chordIndex = 0;
+    };
+
+    // One pass through a section: an entry in the tempo map
+    struct Pass
+    {
+        int section = 0;
+        int firstBar = 0;
+        double startSeconds = 0.0;
+    };
+
+    struct Section
+    {
+        int firstEvent = 0;
+        int numEvents = 0;
+        int numBars = 1;
+        double secondsPerBeat = 0.5;
+        int beatsPerBar = 4;
+        int beatUnit = 4;
+    };
+
+    // Position of a bar: the pass holding it and the chord sounding at its start
+    struct Location
+    {
+        int pass = 0;
+        int event = 0;                  // index into getEvents(): the sounding chord, or the next one
+        bool sounding = false;
+        double seconds = 0.0;
+    };
+
+    ArrangementEngine();
+
+    void compile(const std::vector<ArrangementSection>& sections);
+    void clear();
+
+    int getNumBars() const                          { return numBars; }
+    double getLengthSeconds() const                 { return lengthSeconds; }
+
+    // O(log n); bars past the end clamp to the end of the song
+    double getBarStartSeconds(int bar) const;
+    Location locateBar(int bar) const;
+
+    const std::vector<Pass>& getPasses() const      { return passes; }
+    const std::vector<Section>& getSections() const { return sections; }
+    const std::vector<Event>& getEvents() const     { return events; }
+    const std::vector<ChordNotes>& getChords() const { return chords; }
+
+    const Section& getSectionForPass(int passIndex) const;
+    double getEventSeconds(int passIndex, int eventIndex) const;
+    double getPassEndSeconds(int passIndex) const;
+
+private:
+    int findPass(int bar) const;
+
+    std::vector<ChordNotes> chords;
+    std::vector<Event> events;
+    std::vector<Section> sections;
+    std::vector<Pass> passes;
+
+    int numBars = 0;
+    double lengthSeconds = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ArrangementEngine)
+};
+
+//==============================================================================
+class ArrangementPlayer
+{
+public:
+    struct Step
+    {
+        int chordIndex = -1;            // chord to start, or -1 for none
+        int pass = 0;
+        bool looped = false;            // playback has just jumped back to the loop start
+        bool finished = false;          // the song ended and the player stopped
+    };
+
+    ArrangementPlayer();
+
+    void prepare(double newSampleRate);
+
+    // The arrangement must outlive the player, and must not be recompiled while it's in use
+    void setArrangement(const ArrangementEngine* newArrangement);
+
+    // Plays bars [startBar, endBar) over and over; changes take effect at once
+    void setLoop(int startBar, int endBar);
+    void clearLoop();
+    bool isLooping() const { return looping; }
+
+    // The chord sounding at the bar is due straight away
+    void seekToBar(int bar);
+
+    void start();
+    void stop();
+    bool isPlaying() const { return playing; }
+
+    double getPositionSeconds() const { return positionSamples / sampleRate; }
+
+    // Samples to render before the next step is due, or INT_MAX when stopped
+    int getSamplesUntilNextStep() const;
+
+    void advance(int numSamples);
+
+    bool isStepDue() const { return playing && positionSamples >= getNextStepSamples(); }
+
+    Step takeStep();
+
+private:
+    double getNextStepSamples() const;
+    double getNextEventSamples() const;
+
+    const ArrangementEngine* arrangement = nullptr;
+    double sampleRate = 44100.0;
+
+    bool playing = false;
+    double positionSamples = 0.0;
+    int pass = 0;
+    int nextEvent = 0;                  // index into the arrangement's events
+    bool eventDueNow = false;           // a seek made the sounding chord due
+
+    bool looping = false;
+    int loopStartBar = 0;
+    double loopEndSamples = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ArrangementPlayer)
+};
@@ -0,0 +1,616 @@
+#include "AudioEngine.h"
+
+AudioEngine::AudioEngine()
+{
+    // Decoded once here, before the device starts, and shared by every bass note
+    bass.loadSample();
+    clicks.loadSamples();
+}
+
+AudioEngine::~AudioEngine()
+{
+    freeRetiredArrangements();
+    delete pendingArrangement.exchange(nullptr);
+    delete currentArrangement;
+}
+
+void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate, int newNumOutputChannels)
+{
+    currentSampleRate = sampleRate;
+    numOutputChannels = juce::jmax(1, newNumOutputChannels);
+
+    voices.prepare(sampleRate, samplesPerBlockExpected);
+    voices.setSustain(parameters.sustain);
+
+    bass.prepare(sampleRate, samplesPerBlockExpected);
+    bass.setSustain(parameters.sustain);
+
+    sequencer.prepare(sampleRate);
+    sequencer.setTempo(parameters.tempo);
+
+    strum.prepare(sampleRate);
+    strum.setTempo(parameters.tempo);
+
+    arrangementPlayer.prepare(sampleRate);
+
+    masterEQ.prepare(sampleRate, numOutputChannels);
+
+    clicks.prepare(sampleRate);
+
+    samplePosition = 0;
+}
+
+void AudioEngine::releaseResources()
+{
+    voices.allNotesOff();
+    bass.allNotesOff();
+}
+
+void AudioEngine::renderNextBlock(juce::AudioBuffer<float>& buffer)
+{
+    processBlock(buffer, emptyMidiBuffer);
+}
+
+void AudioEngine::collectCommandsForBlock(int numSamples)
+{
+    // Commands are placed at a fixed one-block delay from when they were posted, so
+    // message-thread jitter shifts them inside the block instead of adding latency.
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+    const double samplesPerMs = currentSampleRate * 0.001;
+    blockStartMs = nowMs;
+
+    numBlockCommands = 0;
+    EngineCommand command;
+
+    while (numBlockCommands < maxCommandsPerBlock && commandQueue.pop(command))
+    {
+        const double ageInSamples = (nowMs - command.timestampMs) * samplesPerMs;
+        const int offset = juce::jlimit(0, juce::jmax(0, numSamples - 1),
+                                        numSamples - juce::roundToInt(ageInSamples));
+
+        // Keep offsets monotonic in case timestamps arrive out of order
+        const int previous = numBlockCommands > 0 ? blockCommandOffsets[static_cast<size_t>(numBlockCommands - 1)] : 0;
+
+        blockCommands[static_cast<size_t>(numBlockCommands)] = command;
+        blockCommandOffsets[static_cast<size_t>(numBlockCommands)] = juce::jmax(previous, offset);
+        ++numBlockCommands;
+    }
+}
+
+void AudioEngine::processBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    const int numSamples = buffer.getNumSamples();
+    buffer.clear();
+
+    collectCommandsForBlock(numSamples);
+    takePendingArrangement();
+    recorder.beginBlock();
+
+    // Walk the block from event to event: UI commands, MIDI and sequencer steps are
+    // applied at their exact sample offset, and the gaps between them are rendered.
+    auto midiIterator = midiMessages.begin();
+    const auto midiEnd = midiMessages.end();
+    int commandIndex = 0;
+    int position = 0;
+
+    auto midiPositionOf = [numSamples](const juce::MidiMessageMetadata& metadata)
+    {
+        return juce::jlimit(0, juce::jmax(0, numSamples - 1), metadata.samplePosition);
+    };
+
+    while (position < numSamples)
+    {
+        eventOffset = position;
+
+        while (commandIndex < numBlockCommands && blockCommandOffsets[static_cast<size_t>(commandIndex)] <= position)
+            handleCommand(blockCommands[static_cast<size_t>(commandIndex++)]);
+
+        while (midiIterator != midiEnd && midiPositionOf(*midiIterator) <= position)
+        {
+            handleMidiEvent((*midiIterator).getMessage());
+            ++midiIterator;
+        }
+
+        while (sequencer.isStepDue())
+            handleSequencerStep(sequencer.takeStep());
+
+        while (arrangementPlayer.isStepDue())
+            handleArrangementStep(arrangementPlayer.takeStep());
+
+        while (strum.isNoteDue())
+        {
+            const auto note = strum.takeDueNote();
+            voices.noteOn(note.midiNote, note.velocity);
+            recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::chordChannel, note.midiNote, note.velocity);
+        }
+
+        int nextEvent = numSamples;
+
+        if (commandIndex < numBlockCommands)
+            nextEvent = juce::jmin(nextEvent, blockCommandOffsets[static_cast<size_t>(commandIndex)]);
+
+        if (midiIterator != midiEnd)
+            nextEvent = juce::jmin(nextEvent, midiPositionOf(*midiIterator));
+
+        const int untilStep = sequencer.getSamplesUntilNextStep();
+        if (untilStep < numSamples - position)
+            nextEvent = juce::jmin(nextEvent, position + untilStep);
+
+        const int untilArrangementStep = arrangementPlayer.getSamplesUntilNextStep();
+        if (untilArrangementStep < numSamples - position)
+            nextEvent = juce::jmin(nextEvent, position + untilArrangementStep);
+
+        // Strummed notes past the end of the block stay pending for the next one
+        const int untilNote = strum.getSamplesUntilNextNote();
+        if (untilNote < numSamples - position)
+            nextEvent = juce::jmin(nextEvent, position + untilNote);
+
+        const int segmentLength = juce::jmax(1, nextEvent - position);
+        renderSegment(buffer, position, segmentLength);
+        sequencer.advance(segmentLength);
+        arrangementPlayer.advance(segmentLength);
+        strum.advance(segmentLength);
+        position += segmentLength;
+    }
+
+    masterEQ.process(buffer, 0, numSamples);
+    recorder.endBlock(buffer, numSamples);
+
+    if (latencyProbeArmed)
+        checkLatencyProbe(buffer);
+
+    samplePosition += numSamples;
+    publishState();
+}
+
+void AudioEngine::publishState()
+{
+    EngineStateSnapshot snapshot;
+    voices.getSoundingNotes(snapshot.soundingNotes);
+    snapshot.bassNote = bass.getSoundingNote();
+    snapshot.chordIndex = currentChordIndex;
+    snapshot.stepIndex = currentStepIndex;
+    snapshot.samplePosition = samplePosition.load();
+    snapshot.blockStartMs = blockStartMs;
+
+    stateBuffer.publish(snapshot);
+}
+
+void AudioEngine::renderSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    voices.render(buffer, startSample, numSamples);
+    bass.render(buffer, startSample, numSamples);
+    clicks.render(buffer, startSample, numSamples);
+}
+
+void AudioEngine::handleSequencerStep(const ProgressionSequencer::Step& step)
+{
+    if (step.clickNumber > 0)
+        clicks.trigger(step.clickNumber);
+
+    if (step.chordIndex < 0)
+        return;
+
+    const auto& chord = sequencer.getChord(step.chordIndex);
+    startChord(chord.notes.data(), chord.numNotes, 1.0f);
+
+    if (chord.bassNote >= 0)
+    {
+        bass.noteOn(chord.bassNote, parameters.bassVolume);
+        recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::bassChannel, chord.bassNote, parameters.bassVolume);
+    }
+
+    currentChordIndex = step.chordIndex;
+    currentStepIndex = step.stepIndex;
+}
+
+void AudioEngine::handleArrangementStep(const ArrangementPlayer::Step& step)
+{
+    if (step.chordIndex >= 0 && currentArrangement != nullptr)
+    {
+        const auto& chord = currentArrangement->getChords()[static_cast<size_t>(step.chordIndex)];
+        startChord(chord.notes.data(), chord.numNotes, 1.0f);
+        currentChordIndex = step.chordIndex;
+        currentStepIndex = step.pass;
+    }
+
+    if (step.finished)
+    {
+        currentChordIndex = -1;
+        currentStepIndex = -1;
+    }
+}
+
+//==============================================================================
+void AudioEngine::loadArrangementFromUI(const std::vector<ArrangementSection>& sections)
+{
+    freeRetiredArrangements();
+
+    auto* arrangement = new ArrangementEngine();
+    arrangement->compile(sections);
+
+    // A song the audio thread never picked up can go straight away
+    delete pendingArrangement.exchange(arrangement);
+}
+
+void AudioEngine::takePendingArrangement()
+{
+    auto* next = pendingArrangement.exchange(nullptr);
+
+    if (next == nullptr)
+        return;
+
+    if (currentArrangement != nullptr)
+    {
+        const bool retired = retiredArrangements.push(currentArrangement);
+        jassert(retired);   // the UI loads songs far slower than this empties
+        juce::ignoreUnused(retired);
+    }
+
+    // Swapping songs stops the player, and with it the chord it was holding
+    if (arrangementPlayer.isPlaying())
+    {
+        currentChordIndex = -1;
+        currentStepIndex = -1;
+        stopAllNotes();
+    }
+
+    currentArrangement = next;
+    arrangementPlayer.setArrangement(currentArrangement);
+}
+
+void AudioEngine::freeRetiredArrangements()
+{
+    ArrangementEngine* retired = nullptr;
+
+    while (retiredArrangements.pop(retired))
+        delete retired;
+}
+
+//==============================================================================
+void AudioEngine::stopAllNotes()
+{
+    forgetFingers();
+    strum.clear();
+    voices.allNotesOff();
+    bass.allNotesOff();
+    recorder.recordAllNotesOff(getEventPosition());
+}
+
+void AudioEngine::startChord(const juce::uint8* notes, int numNotes, float velocity)
+{
+    // A new chord replaces whatever was sounding, like playChord's stopAllSounds()
+    voices.allNotesOff();
+    bass.allNotesOff();
+    strum.clear();
+    forgetFingers();
+    recorder.recordAllNotesOff(getEventPosition());
+
+    addChord(notes, numNotes, velocity);
+}
+
+void AudioEngine::addChord(const juce::uint8* notes, int numNotes, float velocity)
+{
+    const double gap = strum.getSamplesBetweenNotes();
+    const float level = velocity * parameters.chordVolume;
+
+    for (int i = 0; i < numNotes; ++i)
+    {
+        // Offsets are rounded per note from the exact spacing, so they don't accumulate error
+        const int delay = juce::roundToInt(i * gap);
+
+        if (delay == 0)
+        {
+            voices.noteOn(notes[i], level);
+            recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::chordChannel, notes[i], level);
+        }
+        else
+            strum.schedule(notes[i], level, delay);
+    }
+}
+
+void AudioEngine::handleCommand(const EngineCommand& command)
+{
+    switch (command.type)
+    {
+        case EngineCommand::Type::noteOn:
+            if (command.numNotes > 0)
+            {
+                voices.noteOn(command.notes[0], command.velocity * parameters.chordVolume);
+                recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::chordChannel,
+                                      command.notes[0], command.velocity * parameters.chordVolume);
+            }
+            break;
+
+        case EngineCommand::Type::noteOff:
+            if (command.numNotes > 0)
+            {
+                voices.noteOff(command.notes[0]);
+                recorder.recordNoteOff(getEventPosition(), PerformanceRecorder::chordChannel, command.notes[0]);
+            }
+            break;
+
+        case EngineCommand::Type::bassNoteOn:
+            if (command.numNotes > 0)
+            {
+                bass.noteOn(command.notes[0], command.velocity * parameters.bassVolume);
+                recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::bassChannel,
+                                      command.notes[0], command.velocity * parameters.bassVolume);
+            }
+            break;
+
+        case EngineCommand::Type::chordTrigger:
+            startChord(command.notes.data(), command.numNotes, command.velocity);
+            currentChordIndex = -1;
+            currentStepIndex = -1;
+            break;
+
+        case EngineCommand::Type::fingerDown:
+            pressFinger(command);
+            currentChordIndex = -1;
+            currentStepIndex = -1;
+            break;
+
+        case EngineCommand::Type::fingerUp:
+            releaseFinger(command.index);
+            break;
+
+        case EngineCommand::Type::allNotesOff:
+            stopAllNotes();
+            break;
+
+        case EngineCommand::Type::parameterChange:
+            setParameter(command.parameter, command.value);
+            recorder.recordParameter(getEventPosition(), command.parameter, command.value);
+            break;
+
+        case EngineCommand::Type::setProgressionChord:
+            sequencer.setChord(command.index, command.notes.data(), command.numNotes, command.bassNote, command.value);
+            break;
+
+        case EngineCommand::Type::setProgressionLength:
+            sequencer.setNumChords(command.index);
+            break;
+
+        case EngineCommand::Type::startProgression:
+            sequencer.start();
+            break;
+
+        case EngineCommand::Type::stopProgression:
+            sequencer.stop();
+            clicks.stop();
+            currentChordIndex = -1;
+            currentStepIndex = -1;
+            stopAllNotes();
+            break;
+
+        case EngineCommand::Type::playArrangement:
+            arrangementPlayer.seekToBar(command.index);
+            arrangementPlayer.start();
+            break;
+
+        case EngineCommand::Type::stopArrangement:
+            arrangementPlayer.stop();
+            currentChordIndex = -1;
+            currentStepIndex = -1;
+            stopAllNotes();
+            break;
+
+        case EngineCommand::Type::setArrangementLoop:
+            arrangementPlayer.setLoop(command.index, juce::roundToInt(command.value));
+            break;
+    }
+}
+
+//==============================================================================
+void AudioEngine::pressFinger(const EngineCommand& command)
+{
+    if (!juce::isPositiveAndBelow(command.index, maxFingers))
+        return;
+
+    // A finger that never lifted (a lost mouse-up) gives up its old chord first
+    releaseFinger(command.index);
+
+    if (latencyProbeEnabled.load(std::memory_order_relaxed) && !latencyProbeArmed
+        && getNumActiveVoices() == 0 && !sequencer.isPlaying() && !arrangementPlayer.isPlaying())
+        armLatencyProbe(command.timestampMs);
+
+    bool otherFingersHeld = false;
+    for (const auto& finger : fingers)
+        otherFingersHeld = otherFingersHeld || finger.held;
+
+    if (otherFingersHeld)
+        addChord(command.notes.data(), command.numNotes, command.velocity);
+    else
+        startChord(command.notes.data(), command.numNotes, command.velocity);
+
+    if (command.bassNote >= 0)
+    {
+        bass.noteOn(command.bassNote, command.velocity * parameters.bassVolume);
+        recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::bassChannel,
+                              command.bassNote, command.velocity * parameters.bassVolume);
+    }
+
+    auto& finger = fingers[static_cast<size_t>(command.index)];
+    finger.held = true;
+    finger.numNotes = command.numNotes;
+    finger.notes = command.notes;
+    finger.bassNote = command.bassNote;
+}
+
+void AudioEngine::releaseFinger(int fingerIndex)
+{
+    if (!juce::isPositiveAndBelow(fingerIndex, maxFingers))
+        return;
+
+    auto& finger = fingers[static_cast<size_t>(fingerIndex)];
+    if (!finger.held)
+        return;
+
+    finger.held = false;
+
+    // Notes another finger is still holding keep sounding
+    for (int i = 0; i < finger.numNotes; ++i)
+    {
+        const int note = finger.notes[static_cast<size_t>(i)];
+        if (isNoteHeldByFinger(note, false))
+            continue;
+
+        strum.cancel(note);
+        voices.noteOff(note);
+        recorder.recordNoteOff(getEventPosition(), PerformanceRecorder::chordChannel, note);
+    }
+
+    if (finger.bassNote >= 0 && !isNoteHeldByFinger(finger.bassNote, true))
+    {
+        bass.noteOff(finger.bassNote);
+        recorder.recordNoteOff(getEventPosition(), PerformanceRecorder::bassChannel, finger.bassNote);
+    }
+}
+
+bool AudioEngine::isNoteHeldByFinger(int midiNote, bool bassNote) const
+{
+    for (const auto& finger : fingers)
+    {
+        if (!finger.held)
+            continue;
+
+        if (bassNote)
+        {
+            if (finger.bassNote == midiNote)
+                return true;
+
+            continue;
+        }
+
+        for (int i = 0; i < finger.numNotes; ++i)
+            if (finger.notes[static_cast<size_t>(i)] == midiNote)
+                return true;
+    }
+
+    return false;
+}
+
+void AudioEngine::forgetFingers()
+{
+    for (auto& finger : fingers)
+        finger.held = false;
+}
+
+//==============================================================================
+void AudioEngine::armLatencyProbe(double inputMs)
+{
+    latencyProbeArmed = true;
+    latencyProbeInputMs = inputMs;
+    latencyProbeStart = eventOffset;
+}
+
+void AudioEngine::checkLatencyProbe(const juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    for (int sample = latencyProbeStart; sample < numSamples; ++sample)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            if (buffer.getSample(channel, sample) != 0.0f)
+            {
+                LatencyMeasurement measurement;
+                measurement.inputToBlockMs = blockStartMs - latencyProbeInputMs;
+                measurement.offsetInBlockMs = sample * 1000.0 / currentSampleRate;
+                latencyMeasurements.push(measurement);
+
+                latencyProbeArmed = false;
+                return;
+            }
+        }
+    }
+
+    // Still silent (a strum that hasn't started yet): keep looking from the next block's
+    // start, giving up after a second in case the press was never audible at all
+    latencyProbeStart = 0;
+
+    if (blockStartMs - latencyProbeInputMs > 1000.0)
+        latencyProbeArmed = false;
+}
+
+void AudioEngine::setParameterFromAudioThread(EngineParameter parameter, float value)
+{
+    setParameter(parameter, value);
+    recorder.recordParameter(samplePosition.load(), parameter, value);
+}
+
+void AudioEngine::setParameter(EngineParameter parameter, float value)
+{
+    switch (parameter)
+    {
+        case EngineParameter::chordVolume:
+            parameters.chordVolume = juce::jlimit(0.0f, 1.0f, value);
+            break;
+
+        case EngineParameter::bassVolume:
+            parameters.bassVolume = juce::jlimit(0.0f, 1.0f, value);
+            break;
+
+        case EngineParameter::sustain:
+            parameters.sustain = juce::jlimit(10.0f, 200.0f, value);
+            voices.setSustain(parameters.sustain);
+            bass.setSustain(parameters.sustain);
+            break;
+
+        case EngineParameter::tempo:
+            parameters.tempo = juce::jlimit(20.0f, 300.0f, value);
+            sequencer.setTempo(parameters.tempo);
+            strum.setTempo(parameters.tempo);
+            break;
+
+        case EngineParameter::flam:
+        {
+            const int flamIndex = juce::jlimit(0, static_cast<int>(FlamValue::sixteenth), juce::roundToInt(value));
+            strum.setFlam(static_cast<FlamValue>(flamIndex));
+            break;
+        }
+
+        case EngineParameter::eqLow:
+            masterEQ.setBandGain(MasterEQ::Band::low, value);
+            break;
+
+        case EngineParameter::eqMid:
+            masterEQ.setBandGain(MasterEQ::Band::mid, value);
+            break;
+
+        case EngineParameter::eqHigh:
+            masterEQ.setBandGain(MasterEQ::Band::high, value);
+            break;
+
+        case EngineParameter::releaseModel:
+            voices.setReleaseModel(value >= 0.5f ? EnvelopeBank::ReleaseModel::timed
+                                                 : EnvelopeBank::ReleaseModel::noteOff);
+            break;
+
+        case EngineParameter::instrument:
+            voices.setInstrument(static_cast<InstrumentType>(juce::jlimit(0, numInstruments - 1, juce::roundToInt(value))));
+            break;
+    }
+}
+
+void AudioEngine::handleMidiEvent(const juce::MidiMessage& message)
+{
+    if (message.isNoteOn())
+    {
+        voices.noteOn(message.getNoteNumber(), message.getFloatVelocity());
+        recorder.recordNoteOn(getEventPosition(), PerformanceRecorder::chordChannel,
+                              message.getNoteNumber(), message.getFloatVelocity());
+    }
+    else if (message.isNoteOff())
+    {
+        voices.noteOff(message.getNoteNumber());
+        recorder.recordNoteOff(getEventPosition(), PerformanceRecorder::chordChannel, message.getNoteNumber());
+    }
+    else if (message.isAllNotesOff() || message.isAllSoundOff())
+    {
+        stopAllNotes();
+    }
+}
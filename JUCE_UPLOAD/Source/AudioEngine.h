@@ -0,0 +1,248 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "VoicePool.h"
+#include "BassSampler.h"
+#include "ClickSampleBank.h"
+#include "EngineCommandQueue.h"
+#include "ProgressionSequencer.h"
+#include "ArrangementEngine.h"
+#include "StrumScheduler.h"
+#include "MasterEQ.h"
+#include "PerformanceRecorder.h"
+#include "MidiFileWriter.h"
+#include "EngineStateSnapshot.h"
+
+//==============================================================================
+/*
+    Native replacement for the playback side of audio-utils.ts.
+
+    processBlock() runs on the audio thread. It drains the UI command queue, merges
+    those commands with incoming MIDI, progression steps and strummed note starts by
+    sample position, and renders the voice pool and bass sampler in segments between
+    events. Nothing in the render path allocates or locks; all buffers are sized in
+    prepareToPlay().
+*/
+class AudioEngine
+{
+public:
+    AudioEngine();
+    ~AudioEngine();
+
+    // newNumOutputChannels is what the device or host will actually render (mono outputs exist)
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate, int newNumOutputChannels = 2);
+    void releaseResources();
+
+    // Renders into the whole buffer, replacing its contents
+    void processBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages);
+
+    // Renders a block with no external MIDI (the standalone app's device callback)
+    void renderNextBlock(juce::AudioBuffer<float>& buffer);
+
+    //==============================================================================
+    // Message-thread entry points. Each returns false if the queue was full.
+    bool postCommand(const EngineCommand& command) { return commandQueue.push(command); }
+
+    bool noteOnFromUI(int midiNote, float velocity)        { return postCommand(EngineCommand::noteOn(midiNote, velocity)); }
+    bool noteOffFromUI(int midiNote)                       { return postCommand(EngineCommand::noteOff(midiNote)); }
+    bool bassNoteFromUI(int midiNote, float velocity = 1.0f) { return postCommand(EngineCommand::bassNoteOn(midiNote, velocity)); }
+    bool allNotesOffFromUI()                               { return postCommand(EngineCommand::allNotesOff()); }
+    bool setParameterFromUI(EngineParameter p, float v)    { return postCommand(EngineCommand::parameterChange(p, v)); }
+
+    // Audio thread, between blocks: applies a parameter before the next block renders,
+    // e.g. host automation read in the plugin's processBlock
+    void setParameterFromAudioThread(EngineParameter parameter, float value);
+
+    template <typename NoteContainer>
+    bool triggerChordFromUI(const NoteContainer& midiNotes, float velocity = 1.0f)
+    {
+        return postCommand(EngineCommand::chordTrigger(midiNotes, velocity));
+    }
+
+    // A key held by one finger (MouseInputSource index). The first finger down replaces
+    // whatever was sounding, like a tap; further fingers add their chords to it, and each
+    // finger's chord and bass are released when that finger lifts.
+    template <typename NoteContainer>
+    bool fingerDownFromUI(int finger, const NoteContainer& midiNotes, int bassNote, float velocity = 1.0f)
+    {
+        return postCommand(EngineCommand::fingerDown(finger, midiNotes, bassNote, velocity));
+    }
+
+    bool fingerUpFromUI(int finger)   { return postCommand(EngineCommand::fingerUp(finger)); }
+
+    // Loads a progression (a container of note containers) and starts/stops it
+    template <typename ChordContainer>
+    bool loadProgressionFromUI(const ChordContainer& progression)
+    {
+        int index = 0;
+        for (const auto& chordNotes : progression)
+            if (!postCommand(EngineCommand::setProgressionChord(index++, chordNotes)))
+                return false;
+
+        return postCommand(EngineCommand::setProgressionLength(index));
+    }
+
+    // Loads an imported progression with its tempo, and each chord with its bass note
+    // and length in beats. Chords past ProgressionSequencer::maxChords are left out.
+    bool loadProgressionFromUI(const MidiExportProgression& progression)
+    {
+        if (!setParameterFromUI(EngineParameter::tempo, static_cast<float>(progression.bpm)))
+            return false;
+
+        const int numChords = juce::jmin(static_cast<int>(progression.chords.size()), ProgressionSequencer::maxChords);
+        for (int index = 0; index < numChords; ++index)
+        {
+            const auto& chord = progression.chords[static_cast<size_t>(index)];
+            if (!postCommand(EngineCommand::setProgressionChord(index, chord.notes, chord.bassNote, chord.beats)))
+                return false;
+        }
+
+        return postCommand(EngineCommand::setProgressionLength(numChords));
+    }
+
+    bool startProgressionFromUI()   { return postCommand(EngineCommand::startProgression()); }
+    bool stopProgressionFromUI()    { return postCommand(EngineCommand::stopProgression()); }
+
+    // Compiles a song (ArrangementEngine) and hands it to the audio thread, which picks
+    // it up at the start of its next block. The song that was playing stops; the old
+    // arrangement is freed here on a later call, once the audio thread has let it go.
+    void loadArrangementFromUI(const std::vector<ArrangementSection>& sections);
+
+    // Plays the loaded song from any bar, straight away (a seek is O(log n))
+    bool playArrangementFromUI(int fromBar = 0) { return postCommand(EngineCommand::playArrangement(fromBar)); }
+    bool stopArrangementFromUI()                { return postCommand(EngineCommand::stopArrangement()); }
+
+    // Loops bars [startBar, endBar) of the song; an empty range turns looping off
+    bool setArrangementLoopFromUI(int startBar, int endBar)
+    {
+        return postCommand(EngineCommand::setArrangementLoop(startBar, endBar));
+    }
+
+    // Starts a take of everything the engine plays from now on (see PerformanceRecorder)
+    bool startRecordingFromUI(const juce::File& directory, InstrumentType instrument, bool withAudio)
+    {
+        return recorder.start(directory, currentSampleRate, numOutputChannels, withAudio, instrument, getSamplePosition());
+    }
+
+    void stopRecordingFromUI()      { recorder.stop(); }
+    bool isRecording() const        { return recorder.isRecording(); }
+
+    PerformanceRecorder& getRecorder() { return recorder; }
+
+    //==============================================================================
+    // Message thread: what was sounding at the end of the last block, including the
+    // progression chord and step (onChordChange in playProgression). Lock-free, so it
+    // can be read every frame; returns false until the first block has been rendered.
+    bool readStateSnapshot(EngineStateSnapshot& snapshot) const { return stateBuffer.read(snapshot); }
+
+    //==============================================================================
+    // Input-to-output latency measurement. While enabled, a finger press made when
+    // nothing is sounding is followed to the first non-zero sample it produces.
+    struct LatencyMeasurement
+    {
+        double inputToBlockMs = 0.0;    // from the press being posted to the start of the block rendering it
+        double offsetInBlockMs = 0.0;   // from the block start to the first non-zero sample
+    };
+
+    void setLatencyProbeEnabled(bool shouldBeEnabled) { latencyProbeEnabled = shouldBeEnabled; }
+
+    // Message thread: returns the next finished measurement, if any
+    bool popLatencyMeasurement(LatencyMeasurement& measurement) { return latencyMeasurements.pop(measurement); }
+
+    // Total samples rendered since prepareToPlay()
+    juce::int64 getSamplePosition() const { return samplePosition.load(); }
+
+    int getNumActiveVoices() const { return voices.getNumActiveVoices() + bass.getNumActiveVoices(); }
+
+private:
+    // Parameter values as seen by the audio thread
+    struct Parameters
+    {
+        float chordVolume = 0.25f; // VerticalFaderComponent's initial value
+        float bassVolume = 0.75f;
+        float sustain = 100.0f;
+        float tempo = 120.0f;
+    };
+
+    void collectCommandsForBlock(int numSamples);
+    void handleCommand(const EngineCommand& command);
+    void handleMidiEvent(const juce::MidiMessage& message);
+    void setParameter(EngineParameter parameter, float value);
+    void handleSequencerStep(const ProgressionSequencer::Step& step);
+    void handleArrangementStep(const ArrangementPlayer::Step& step);
+    void takePendingArrangement();
+    void freeRetiredArrangements();
+    void stopAllNotes();
+    void startChord(const juce::uint8* notes, int numNotes, float velocity);
+    void addChord(const juce::uint8* notes, int numNotes, float velocity);
+    void pressFinger(const EngineCommand& command);
+    void releaseFinger(int finger);
+    bool isNoteHeldByFinger(int midiNote, bool bass) const;
+    void forgetFingers();
+    void armLatencyProbe(double inputMs);
+    void checkLatencyProbe(const juce::AudioBuffer<float>& buffer);
+    void renderSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void publishState();
+
+    // Sample clock position of the event being handled, for the recorder
+    juce::int64 getEventPosition() const { return samplePosition.load() + eventOffset; }
+
+    VoicePool voices;
+    BassSampler bass;
+    ProgressionSequencer sequencer;
+    ArrangementPlayer arrangementPlayer;
+    StrumScheduler strum;
+    MasterEQ masterEQ;
+    ClickSampleBank clicks;
+    PerformanceRecorder recorder;
+
+    Parameters parameters;
+
+    EngineCommandQueue commandQueue;
+
+    // Commands drained for the current block, with their sample offsets
+    static constexpr int maxCommandsPerBlock = 256;
+    std::array<EngineCommand, maxCommandsPerBlock> blockCommands;
+    std::array<int, maxCommandsPerBlock> blockCommandOffsets {};
+    int numBlockCommands = 0;
+    int eventOffset = 0;    // position in the block of the events being handled
+
+    // Songs pass from the message thread to the audio thread by pointer swap: the UI
+    // publishes a compiled arrangement in pendingArrangement, the audio thread takes it
+    // and hands the one it replaces back through retiredArrangements for the UI to free.
+    std::atomic<ArrangementEngine*> pendingArrangement { nullptr };
+    ArrangementEngine* currentArrangement = nullptr;   // audio thread
+    LockFreeQueue<ArrangementEngine*, 16> retiredArrangements;
+
+    // The chord and bass each finger is holding, until its fingerUp
+    struct FingerChord
+    {
+        bool held = false;
+        int numNotes = 0;
+        std::array<juce::uint8, EngineCommand::maxChordNotes> notes {};
+        int bassNote = -1;
+    };
+
+    static constexpr int maxFingers = 10;
+    std::array<FingerChord, maxFingers> fingers;
+
+    // Latency probe: armed by a press, fired by the first non-zero sample after it
+    std::atomic<bool> latencyProbeEnabled { false };
+    bool latencyProbeArmed = false;
+    double latencyProbeInputMs = 0.0;
+    int latencyProbeStart = 0;
+    LockFreeQueue<LatencyMeasurement, 16> latencyMeasurements;
+
+    // Progression chord sounding now, for the state snapshot (-1 when none)
+    int currentChordIndex = -1;
+    int currentStepIndex = -1;
+    double blockStartMs = 0.0;
+    EngineStateBuffer stateBuffer;
+    std::atomic<juce::int64> samplePosition { 0 };
+
+    juce::MidiBuffer emptyMidiBuffer;
+    double currentSampleRate = 44100.0;
+    int numOutputChannels = 2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
+};
@@ -0,0 +1,207 @@
+#include "BassSampler.h"
+#include "SoundResources.h"
+#include <iostream>
+
+BassSampler::BassSampler()
+{
+    monoBuffer.setSize(1, 512);
+    createFallbackSample();
+}
+
+void BassSampler::loadSample()
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (auto stream = SoundResources::open("sounds", "BASS.mp3"))
+        reader.reset(formatManager.createReaderFor(std::move(stream)));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+    {
+        std::cout << "Bass sample BASS.mp3 not found, using synthesized bass" << std::endl;
+        return;
+    }
+
+    juce::AudioBuffer<float> decoded(static_cast<int>(reader->numChannels),
+                                     static_cast<int>(reader->lengthInSamples));
+    reader->read(&decoded, 0, decoded.getNumSamples(), 0, true, true);
+
+    setSampleData(decoded, reader->sampleRate);
+}
+
+void BassSampler::setSampleData(const juce::AudioBuffer<float>& source, double sourceSampleRate)
+{
+    sampleLength = source.getNumSamples();
+    sampleRateOfSource = sourceSampleRate;
+
+    // Mix down to mono between two runs of silence
+    sampleData.setSize(1, sampleLength + 2 * padding);
+    sampleData.clear();
+
+    const float channelGain = 1.0f / static_cast<float>(juce::jmax(1, source.getNumChannels()));
+    for (int channel = 0; channel < source.getNumChannels(); ++channel)
+        sampleData.addFrom(0, padding, source, channel, 0, sampleLength, channelGain);
+}
+
+void BassSampler::createFallbackSample()
+{
+    // A plucked-bass-like tone at the sample's root pitch: a few decaying harmonics
+    const double rate = 44100.0;
+    const int length = static_cast<int>(rate * 2.0);
+    const double frequency = juce::MidiMessage::getMidiNoteInHertz(sampleRootNote);
+
+    juce::AudioBuffer<float> tone(1, length);
+    auto* data = tone.getWritePointer(0);
+
+    for (int i = 0; i < length; ++i)
+    {
+        const double t = i / rate;
+        const double attack = juce::jmin(1.0, t / 0.005);
+        const double envelope = attack * std::exp(-t * 2.5);
+
+        double sample = 0.0;
+        for (int harmonic = 1; harmonic <= 6; ++harmonic)
+            sample += std::sin(juce::MathConstants<double>::twoPi * frequency * harmonic * t)
+                        * std::exp(-t * harmonic) / std::pow(harmonic, 1.5);
+
+        data[i] = static_cast<float>(0.6 * envelope * sample);
+    }
+
+    setSampleData(tone, rate);
+}
+
+void BassSampler::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    monoBuffer.setSize(1, maximumBlockSize);
+
+    // 10 ms fade when a note is cut
+    fadeSamples = juce::jmax(1, juce::roundToInt(0.01 * sampleRate));
+
+    for (auto& voice : voices)
+        voice = BassVoice();
+}
+
+void BassSampler::setSustain(float sustainPercent)
+{
+    sustain = juce::jlimit(10.0f, 200.0f, sustainPercent);
+}
+
+BassVoice& BassSampler::findVoiceToStart()
+{
+    for (auto& voice : voices)
+        if (!voice.isActive)
+            return voice;
+
+    BassVoice* oldest = &voices[0];
+    for (auto& voice : voices)
+        if (voice.age < oldest->age)
+            oldest = &voice;
+
+    return *oldest;
+}
+
+void BassSampler::noteOn(int midiNote, float volume)
+{
+    auto& voice = findVoiceToStart();
+
+    const double ratio = std::pow(2.0, (midiNote + 12 - sampleRootNote) / 12.0) * sampleRateOfSource / sampleRate;
+
+    voice.position = 0.0;
+    voice.increment = ratio;
+    voice.band = SincInterpolator::getBandForRatio(ratio);
+    voice.gain = volumeScale * volume;
+    voice.fade = 1.0f;
+    voice.samplesUntilRelease = juce::roundToInt(sustain * 0.1 * sampleRate);
+    voice.isActive = true;
+    voice.isReleasing = false;
+    voice.midiNote = midiNote;
+    voice.age = nextAge++;
+}
+
+void BassSampler::noteOff(int midiNote)
+{
+    for (auto& voice : voices)
+        if (voice.isActive && voice.midiNote == midiNote)
+            voice.isReleasing = true;
+}
+
+void BassSampler::allNotesOff()
+{
+    for (auto& voice : voices)
+        if (voice.isActive)
+            voice.isReleasing = true;
+}
+
+void BassSampler::render(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        const int chunk = juce::jmin(numSamples, monoBuffer.getNumSamples());
+        renderChunk(buffer, startSample, chunk);
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+}
+
+void BassSampler::renderChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (getNumActiveVoices() == 0)
+        return;
+
+    monoBuffer.clear(0, 0, numSamples);
+    auto* mono = monoBuffer.getWritePointer(0);
+    const float* source = sampleData.getReadPointer(0, padding);
+    const float fadeStep = 1.0f / static_cast<float>(fadeSamples);
+
+    for (auto& voice : voices)
+    {
+        if (!voice.isActive)
+            continue;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int index = static_cast<int>(voice.position);
+
+            if (index >= sampleLength || voice.fade <= 0.0f)
+            {
+                voice.isActive = false;
+                break;
+            }
+
+            const float fraction = static_cast<float>(voice.position - index);
+            mono[i] += voice.gain * voice.fade * interpolator.interpolate(source + index, fraction, voice.band);
+
+            voice.position += voice.increment;
+
+            if (voice.isReleasing)
+                voice.fade = juce::jmax(0.0f, voice.fade - fadeStep);
+            else if (--voice.samplesUntilRelease <= 0)
+                voice.isReleasing = true;
+        }
+    }
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        buffer.addFrom(channel, startSample, monoBuffer, 0, 0, numSamples);
+}
+
+int BassSampler::getNumActiveVoices() const
+{
+    int count = 0;
+    for (const auto& voice : voices)
+        if (voice.isActive)
+            ++count;
+    return count;
+}
+
+int BassSampler::getSoundingNote() const
+{
+    const BassVoice* newest = nullptr;
+
+    for (const auto& voice : voices)
+        if (voice.isActive && !voice.isReleasing && (newest == nullptr || voice.age > newest->age))
+            newest = &voice;
+
+    return newest != nullptr ? newest->midiNote : -1;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "SincInterpolator.h"
+
+// One sounding bass note, reading the shared sample at its own rate
+struct BassVoice
+{
+    double position = 0.0;      // read position in source samples
+    double increment = 1.0;     // source samples per output sample
+    int band = 0;               // SincInterpolator table for this ratio
+
+    float gain = 0.0f;
+    float fade = 1.0f;          // 1 while playing, ramps to 0 once released
+    int samplesUntilRelease = 0;
+
+    bool isActive = false;
+    bool isReleasing = false;
+
+    int midiNote = -1;
+    juce::uint32 age = 0;
+};
+
+//==============================================================================
+/*
+    Native counterpart of playBassNote() in audio-utils.ts.
+
+    The reference creates and unloads a sound object per bass note. Here the bass
+    sample is decoded once into a single in-memory buffer, and a small fixed set of
+    voices reads from it, repitched with SincInterpolator. Starting a note (with any
+    bass offset) only sets up a voice, with no allocation or file access.
+
+    As in the reference, notes are shifted up an octave, played at 85% of the
+    given volume and cut after sustain * 100 ms. They also stop when a new chord
+    calls stopAllSounds(). The cut is a short fade rather than an unload, so it
+    doesn't click.
+*/
+class BassSampler
+{
+public:
+    static constexpr int maxVoices = 8;
+
+    BassSampler();
+
+    // Message thread, before audio starts: decodes BASS.mp3 (see SoundResources). If
+    // it can't be found or read, a synthesized tone at the same pitch is used instead.
+    void loadSample();
+
+    void prepare(double newSampleRate, int maximumBlockSize);
+
+    // Sustain in percent (10-200); sets how long a note plays before it's cut
+    void setSustain(float sustainPercent);
+
+    void noteOn(int midiNote, float volume);
+
+    // Fades out the voices playing this note, e.g. when the finger that started it lifts
+    void noteOff(int midiNote);
+    void allNotesOff();
+
+    // Adds the active voices into the given region of the buffer
+    void render(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    int getNumActiveVoices() const;
+
+    // The most recent note that hasn't been released, or -1
+    int getSoundingNote() const;
+
+private:
+    BassVoice& findVoiceToStart();
+    void renderChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void setSampleData(const juce::AudioBuffer<float>& source, double sourceSampleRate);
+    void createFallbackSample();
+
+    // Zero padding on both sides of the sample, for the interpolator's taps
+    static constexpr int padding = SincInterpolator::numTaps;
+
+    SincInterpolator interpolator;
+
+    juce::AudioBuffer<float> sampleData; // mono, padded
+    int sampleLength = 0;
+    double sampleRateOfSource = 44100.0;
+
+    std::array<BassVoice, maxVoices> voices;
+    juce::AudioBuffer<float> monoBuffer;
+    double sampleRate = 44100.0;
+    float sustain = 100.0f;
+    int fadeSamples = 441;
+    juce::uint32 nextAge = 0;
+
+    // The sample is a C4, played back one octave up: rate = 2^((note + 12 - 60) / 12)
+    static constexpr int sampleRootNote = 60;
+    static constexpr float volumeScale = 0.85f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BassSampler)
+};
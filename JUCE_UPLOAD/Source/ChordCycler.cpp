@@ -0,0 +1,184 @@
+#include "ChordCycler.h"
+
+namespace
+{
+    // CHORD_PRIORITIES (chord-utils.ts)
+    constexpr ChordType triadPriorities[] = { ChordType::major, ChordType::minor };
+
+    constexpr ChordType fourNotePriorities[] =
+    {
+        ChordType::dominant7, ChordType::major7, ChordType::minor7,
+        ChordType::minor7Flat5, ChordType::diminished7,
+        ChordType::augmented, ChordType::diminished, ChordType::sus2, ChordType::sus4,
+        ChordType::major, ChordType::minor
+    };
+
+    constexpr ChordType higherPriorities[] =
+    {
+        ChordType::major9, ChordType::minor9, ChordType::dominant9,
+        ChordType::sixNine, ChordType::dominant11,
+        ChordType::major7, ChordType::minor7, ChordType::dominant7,
+        ChordType::major, ChordType::minor
+    };
+
+    // getAllChordTypes(): the groups above merged, first appearance first
+    constexpr ChordType randomPriorities[] =
+    {
+        ChordType::major, ChordType::minor,
+        ChordType::dominant7, ChordType::major7, ChordType::minor7, ChordType::minor7Flat5, ChordType::diminished7,
+        ChordType::augmented, ChordType::diminished, ChordType::sus2, ChordType::sus4,
+        ChordType::major9, ChordType::minor9, ChordType::dominant9, ChordType::sixNine, ChordType::dominant11
+    };
+
+    struct CycleList
+    {
+        std::array<ChordType, numChordTypes> types {};
+        int numTypes = 0;
+
+        constexpr void add(ChordType type)  { types[static_cast<size_t>(numTypes++)] = type; }
+    };
+
+    template <size_t numPriorities>
+    constexpr void addDiatonic(CycleList& list, const ChordType (&priorities)[numPriorities], int degree, juce::uint16 scaleMask)
+    {
+        for (auto type : priorities)
+            if (isMaskSubsetOf(getChordMask(degree, type), scaleMask))
+                list.add(type);
+    }
+
+    // degree = semitones above the key
+    constexpr CycleList makeCycleList(MusicMode mode, int degree, ChordGroup group)
+    {
+        CycleList list;
+        const auto scaleMask = getScaleMask(0, mode);
+
+        if (!containsPitchClass(scaleMask, degree))
+            return list;
+
+        if (mode == MusicMode::free)
+        {
+            for (const auto& chord : chordTable)
+                list.add(chord.type);
+
+            return list;
+        }
+
+        switch (group)
+        {
+            case ChordGroup::triad:     addDiatonic(list, triadPriorities, degree, scaleMask); break;
+            case ChordGroup::fourNote:  addDiatonic(list, fourNotePriorities, degree, scaleMask); break;
+            case ChordGroup::higher:    addDiatonic(list, higherPriorities, degree, scaleMask); break;
+            case ChordGroup::random:    addDiatonic(list, randomPriorities, degree, scaleMask); break;
+        }
+
+        if (list.numTypes == 0)
+        {
+            const auto diatonic = getDiatonicChordTypes(0, mode, degree);
+
+            for (auto type : diatonicCandidateTypes)
+                if (containsChordType(diatonic, type))
+                    list.add(type);
+        }
+
+        return list;
+    }
+
+    constexpr int getCycleIndex(MusicMode mode, int degree, ChordGroup group)
+    {
+        return (static_cast<int>(mode) * 12 + degree) * numChordGroups + static_cast<int>(group);
+    }
+
+    constexpr std::array<CycleList, static_cast<size_t>(numModes * 12 * numChordGroups)> makeCycleTable()
+    {
+        std::array<CycleList, static_cast<size_t>(numModes * 12 * numChordGroups)> table {};
+
+        for (int mode = 0; mode < numModes; ++mode)
+            for (int degree = 0; degree < 12; ++degree)
+                for (int group = 0; group < numChordGroups; ++group)
+                    table[static_cast<size_t>(getCycleIndex(static_cast<MusicMode>(mode), degree, static_cast<ChordGroup>(group)))]
+                        = makeCycleList(static_cast<MusicMode>(mode), degree, static_cast<ChordGroup>(group));
+
+        return table;
+    }
+
+    constexpr auto cycleTable = makeCycleTable();
+
+    static_assert(cycleTable[getCycleIndex(MusicMode::major, 11, ChordGroup::triad)].types[0] == ChordType::diminished,
+                  "TRIAD on the major scale's 7th degree falls back to its diminished triad");
+    static_assert(cycleTable[getCycleIndex(MusicMode::major, 1, ChordGroup::triad)].numTypes == 0,
+                  "Degrees off the scale have no chords");
+
+    const CycleList& getCycleList(MusicMode mode, int degree, ChordGroup group)
+    {
+        return cycleTable[static_cast<size_t>(getCycleIndex(mode, degree, group))];
+    }
+}
+
+//==============================================================================
+ChordCycler::ChordCycler()
+{
+    setSeed(juce::Time::currentTimeMillis());
+}
+
+void ChordCycler::setScale(int keyPitchClass, MusicMode newMode)
+{
+    key = getPitchClass(keyPitchClass);
+
+    if (newMode != mode)
+    {
+        mode = newMode;
+        resetCursors();
+    }
+}
+
+void ChordCycler::setGroup(ChordGroup newGroup)
+{
+    if (newGroup != group)
+    {
+        group = newGroup;
+        resetCursors();
+    }
+}
+
+void ChordCycler::setSeed(juce::int64 newSeed)
+{
+    seed = newSeed;
+    random.setSeed(seed);
+}
+
+void ChordCycler::resetCursors()
+{
+    cursors.fill(0);
+}
+
+int ChordCycler::getDegree(int slot) const
+{
+    return getPitchClass(slot / maxSectionsPerKey - key);
+}
+
+ChordType ChordCycler::getChordType(int slot) const
+{
+    jassert(juce::isPositiveAndBelow(slot, numSlots));
+
+    const auto& list = getCycleList(mode, getDegree(slot), group);
+    if (list.numTypes == 0)
+        return ChordType::major;
+
+    return list.types[static_cast<size_t>(cursors[static_cast<size_t>(slot)] % list.numTypes)];
+}
+
+void ChordCycler::cycle(int slot, int direction)
+{
+    jassert(juce::isPositiveAndBelow(slot, numSlots));
+
+    const auto& list = getCycleList(mode, getDegree(slot), group);
+    if (list.numTypes == 0)
+        return;
+
+    auto& cursor = cursors[static_cast<size_t>(slot)];
+
+    if (group == ChordGroup::random)
+        cursor = static_cast<juce::uint8>(random.nextInt(list.numTypes));
+    else
+        cursor = static_cast<juce::uint8>((cursor % list.numTypes + direction % list.numTypes + list.numTypes) % list.numTypes);
+}
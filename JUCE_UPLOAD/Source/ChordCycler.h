@@ -0,0 +1,84 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "ScaleTables.h"
+
+//==============================================================================
+/*
+    Chord groups from CHORD_PRIORITIES (chord-utils.ts). RANDOM picks from the
+    union of the other groups.
+*/
+enum class ChordGroup : juce::uint8
+{
+    triad,
+    fourNote,
+    higher,
+    random
+};
+
+inline constexpr int numChordGroups = 4;
+
+//==============================================================================
+/*
+    Per-key chord-type cycling: the native version of chordTypeIndices,
+    getCurrentChordType() and adjustLastChordType() in PianoXL.tsx.
+
+    Each mode, scale degree and group has a fixed cycle list, built at compile
+    time. In FREE mode the list is every chord type, as in ALL_CHORD_TYPES.
+    Otherwise it's the group's CHORD_PRIORITIES list with non-diatonic chords
+    dropped. If nothing survives (TRIAD on a diminished degree, say), the
+    degree's diatonic chords from ScaleTables are used instead. Lists depend
+    only on the distance from the key, so 8 modes x 12 degrees x 4 groups cover
+    every key.
+
+    Each key slot keeps a cursor into its list in a dense array. A tap reads the
+    cursor and a plus/minus step moves it, so neither builds or filters a list.
+    RANDOM jumps the cursor with a seeded juce::Random, so a session replays the
+    same way from the same seed.
+*/
+class ChordCycler
+{
+public:
+    // XXL and XXXL split each key into two or three slots
+    static constexpr int maxSectionsPerKey = 3;
+    static constexpr int numSlots = 12 * maxSectionsPerKey;
+
+    static int getSlot(int pitchClass, int section = 0)
+    {
+        return getPitchClass(pitchClass) * maxSectionsPerKey + juce::jlimit(0, maxSectionsPerKey - 1, section);
+    }
+
+    ChordCycler();
+
+    // A mode change clears every slot back to its first chord, as PianoXL does
+    void setScale(int keyPitchClass, MusicMode mode);
+    void setGroup(ChordGroup newGroup);
+    ChordGroup getGroup() const { return group; }
+
+    void setSeed(juce::int64 seed);
+    juce::int64 getSeed() const { return seed; }
+
+    // Chord type a slot plays now; major for slots off the scale
+    ChordType getChordType(int slot) const;
+
+    // Moves a slot on through its list (direction +1/-1). RANDOM ignores the
+    // direction and jumps to a random entry.
+    void cycle(int slot, int direction);
+
+    void resetCursors();
+
+private:
+    int getDegree(int slot) const;
+
+    int key = 0;
+    MusicMode mode = MusicMode::free;
+    ChordGroup group = ChordGroup::triad;
+
+    std::array<juce::uint8, numSlots> cursors {};
+
+    juce::int64 seed = 0;
+    juce::Random random;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChordCycler)
+};
@@ -0,0 +1,225 @@
+#include "ChordRecognizer.h"
+
+namespace
+{
+    int countPitchClasses(juce::uint16 mask)
+    {
+        return juce::countNumberOfBits(static_cast<juce::uint32>(mask));
+    }
+
+    // Parses a note name at the start of text ("C", "F#", "Bb"), returning its pitch
+    // class and how many characters it used, or -1
+    int parseNoteName(juce::String::CharPointerType text, int& length)
+    {
+        static constexpr int letterPitchClasses[] = { 9, 11, 0, 2, 4, 5, 7 };  // A..G
+
+        const auto letter = juce::CharacterFunctions::toUpperCase(*text);
+        if (letter < 'A' || letter > 'G')
+            return -1;
+
+        int pitchClass = letterPitchClasses[letter - 'A'];
+        length = 1;
+
+        for (++text; ; ++text)
+        {
+            const auto c = *text;
+
+            if (c == '#' || c == 0x266f)        // '#' or U+266F sharp sign
+                ++pitchClass;
+            else if (c == 'b' || c == 0x266d)   // 'b' or U+266D flat sign
+                --pitchClass;
+            else
+                break;
+
+            ++length;
+        }
+
+        return getPitchClass(pitchClass);
+    }
+
+    // Suffix spellings accepted besides the table's own suffixes and keys
+    struct SuffixAlias
+    {
+        const char* text;
+        ChordType type;
+    };
+
+    constexpr SuffixAlias suffixAliases[] =
+    {
+        { "M",      ChordType::major },
+        { "maj",    ChordType::major },
+        { "min",    ChordType::minor },
+        { "-",      ChordType::minor },
+        { "+",      ChordType::augmented },
+        { "sus",    ChordType::sus4 },
+        { "-7",     ChordType::minor7 },
+        { "min7",   ChordType::minor7 }
+    };
+
+    bool findChordType(const juce::String& suffix, ChordType& type)
+    {
+        // Display suffixes first: they're case-sensitive ("M7" vs "m7")
+        for (const auto& chord : chordTable)
+        {
+            if (suffix == juce::String(juce::CharPointer_UTF8(chord.suffix)))
+            {
+                type = chord.type;
+                return true;
+            }
+        }
+
+        for (const auto& chord : chordTable)
+        {
+            if (suffix == juce::String(juce::CharPointer_UTF8(chord.id)))
+            {
+                type = chord.type;
+                return true;
+            }
+        }
+
+        for (const auto& alias : suffixAliases)
+        {
+            if (suffix == alias.text)
+            {
+                type = alias.type;
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+//==============================================================================
+ChordRecognizer::ChordRecognizer()
+{
+    // Exact matches: every chord on every root lands in the entry for its own set.
+    // Walking the table in order keeps the common chord types ahead of the rarer
+    // spellings of the same notes.
+    for (const auto& chord : chordTable)
+        for (int root = 0; root < 12; ++root)
+        {
+            const auto chordMask = getChordMask(root, chord.type);
+            addCandidate(table[chordMask], root, chord.type, chordMask);
+        }
+
+    // Everything else takes the largest chords it contains, so a chord with an
+    // added or doubled-up extra note still gets a name
+    for (int set = 0; set < numPitchClassSets; ++set)
+    {
+        auto& entry = table[static_cast<size_t>(set)];
+        if (entry.numCandidates > 0)
+            continue;
+
+        int bestSize = 0;
+
+        for (const auto& chord : chordTable)
+            for (int root = 0; root < 12; ++root)
+            {
+                const auto chordMask = getChordMask(root, chord.type);
+                if (!isMaskSubsetOf(chordMask, static_cast<juce::uint16>(set)))
+                    continue;
+
+                const int size = countPitchClasses(chordMask);
+                if (size > bestSize)
+                {
+                    bestSize = size;
+                    entry.numCandidates = 0;
+                }
+
+                if (size == bestSize)
+                    addCandidate(entry, root, chord.type, chordMask);
+            }
+    }
+}
+
+void ChordRecognizer::addCandidate(Entry& entry, int root, ChordType type, juce::uint16 chordMask)
+{
+    // Skip aliases such as M7 for major7: same root, same notes
+    for (int i = 0; i < entry.numCandidates; ++i)
+    {
+        const auto& existing = entry.candidates[static_cast<size_t>(i)];
+        if (existing.root == root && getChordMask(existing.root, existing.type) == chordMask)
+            return;
+    }
+
+    if (entry.numCandidates < maxCandidates)
+        entry.candidates[static_cast<size_t>(entry.numCandidates++)] = { static_cast<juce::uint8>(root), type };
+}
+
+RecognizedChord ChordRecognizer::recognize(juce::uint16 pitchClassMask, int bassPitchClass) const
+{
+    RecognizedChord result;
+    result.bass = bassPitchClass;
+
+    const auto& entry = table[static_cast<size_t>(pitchClassMask & 0xfff)];
+    if (entry.numCandidates == 0)
+        return result;
+
+    // Bass disambiguation: the first candidate rooted on the bass wins
+    const Candidate* best = &entry.candidates[0];
+
+    for (int i = 0; i < entry.numCandidates; ++i)
+    {
+        if (entry.candidates[static_cast<size_t>(i)].root == bassPitchClass)
+        {
+            best = &entry.candidates[static_cast<size_t>(i)];
+            break;
+        }
+    }
+
+    result.root = best->root;
+    result.type = best->type;
+    return result;
+}
+
+//==============================================================================
+juce::String ChordRecognizer::getChordName(const RecognizedChord& chord)
+{
+    if (!chord.isValid())
+        return chord.bass >= 0 ? juce::String(pitchClassNames[static_cast<size_t>(chord.bass)]) : juce::String();
+
+    auto name = juce::String(pitchClassNames[static_cast<size_t>(chord.root)])
+              + juce::String(juce::CharPointer_UTF8(getChord(chord.type).suffix));
+
+    if (chord.isSlashChord())
+        name << "/" << pitchClassNames[static_cast<size_t>(chord.bass)];
+
+    return name;
+}
+
+RecognizedChord ChordRecognizer::parseChordName(const juce::String& text)
+{
+    const auto trimmed = text.trim();
+    RecognizedChord result;
+
+    int rootLength = 0;
+    const int root = parseNoteName(trimmed.getCharPointer(), rootLength);
+    if (root < 0)
+        return result;
+
+    auto suffix = trimmed.substring(rootLength);
+    int bass = root;
+
+    const int slash = suffix.lastIndexOfChar('/');
+    if (slash >= 0)
+    {
+        const auto bassText = suffix.substring(slash + 1).trim();
+        int bassLength = 0;
+        bass = parseNoteName(bassText.getCharPointer(), bassLength);
+
+        if (bass < 0 || bassLength != bassText.length())
+            return result;
+
+        suffix = suffix.substring(0, slash);
+    }
+
+    ChordType type = ChordType::major;
+    if (!findChordType(suffix.trim(), type))
+        return result;
+
+    result.root = root;
+    result.type = type;
+    result.bass = bass;
+    return result;
+}
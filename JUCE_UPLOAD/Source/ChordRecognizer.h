@@ -0,0 +1,92 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "ChordTable.h"
+
+//==============================================================================
+/*
+    Names the chord formed by a set of held notes, filling in the getChordFromMidi()
+    and getChordFromString() placeholders in chord-utils.ts.
+
+    Every one of the 4096 pitch-class sets is resolved once, in the constructor,
+    to a short list of (root, type) candidates: the chords whose notes are exactly
+    that set, or failing that the largest chords contained in it. Recognizing is
+    then a table lookup plus a pass over at most maxCandidates entries that
+    prefers the candidate rooted on the bass note, so C-E-G-A over A reads Am7 and
+    over C reads C6. When no candidate is rooted on the bass it becomes a slash
+    chord.
+*/
+struct RecognizedChord
+{
+    int root = -1;                      // pitch class, or -1 when no chord was found
+    ChordType type = ChordType::major;
+    int bass = -1;                      // pitch class of the lowest note, or -1 for none
+
+    bool isValid() const        { return root >= 0; }
+    bool isSlashChord() const   { return isValid() && bass >= 0 && bass != root; }
+
+    bool operator== (const RecognizedChord& other) const
+    {
+        return root == other.root && type == other.type && bass == other.bass;
+    }
+
+    bool operator!= (const RecognizedChord& other) const    { return !operator== (other); }
+};
+
+class ChordRecognizer
+{
+public:
+    ChordRecognizer();
+
+    // Constant time: one table lookup and a scan of a handful of candidates
+    RecognizedChord recognize(juce::uint16 pitchClassMask, int bassPitchClass) const;
+
+    // Recognizes a container of MIDI note numbers; the lowest note is the bass
+    template <typename NoteContainer>
+    RecognizedChord recognizeNotes(const NoteContainer& midiNotes) const
+    {
+        juce::uint16 mask = 0;
+        int lowestNote = 128;
+
+        for (auto note : midiNotes)
+        {
+            mask = static_cast<juce::uint16>(mask | (1 << getPitchClass(static_cast<int>(note))));
+            lowestNote = juce::jmin(lowestNote, static_cast<int>(note));
+        }
+
+        return recognize(mask, lowestNote < 128 ? getPitchClass(lowestNote) : -1);
+    }
+
+    // Display name as getChordName()/getChordNameWithBass() build it, e.g. "Am7/G".
+    // A lone note without a chord is shown by its name; nothing gives "".
+    static juce::String getChordName(const RecognizedChord& chord);
+
+    // Parses names such as "C", "F#m7", "Bbmaj7/D" or "Ebminor9". Accepts the
+    // display suffixes, the chordIntervals keys and a few common spellings ("maj",
+    // "min", "-", "+"). Returns an invalid chord when the text isn't a chord name.
+    static RecognizedChord parseChordName(const juce::String& text);
+
+    static constexpr int maxCandidates = 8;
+
+private:
+    struct Candidate
+    {
+        juce::uint8 root = 0;
+        ChordType type = ChordType::major;
+    };
+
+    struct Entry
+    {
+        std::array<Candidate, maxCandidates> candidates;
+        int numCandidates = 0;
+    };
+
+    static constexpr int numPitchClassSets = 1 << 12;
+
+    void addCandidate(Entry& entry, int root, ChordType type, juce::uint16 chordMask);
+
+    std::array<Entry, numPitchClassSets> table;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChordRecognizer)
+};
@@ -0,0 +1,140 @@
+#include "ChordSuggestionEngine.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    struct Target
+    {
+        int degree;
+        ChordType type;
+        juce::uint16 mask;
+        int numNotes;
+        int commonness;     // position in diatonicCandidateTypes, 0 = most common
+    };
+
+    struct ScoredTarget
+    {
+        const Target* target;
+        float weight;
+    };
+
+    float getTransitionWeight(int fromDegree, ChordType fromType, const Target& to)
+    {
+        const int rootMotion = getPitchClass(to.degree - fromDegree);
+        float weight = 0.0f;
+
+        // Fourth up (V-I) and fifth up, as in getChordSuggestions, with the
+        // resolution slightly ahead
+        if (rootMotion == 5)
+            weight += 3.5f;
+        else if (rootMotion == 7)
+            weight += 3.0f;
+
+        // Relative minor/major
+        if ((fromType == ChordType::major && to.type == ChordType::minor && rootMotion == 9)
+            || (fromType == ChordType::minor && to.type == ChordType::major && rootMotion == 3))
+            weight += 3.0f;
+
+        if (rootMotion == 2 || rootMotion == 10)
+            weight += 1.0f;
+
+        // Share of the new chord already sounding, up to +1
+        const auto fromMask = getChordMask(fromDegree, fromType);
+        const auto commonTones = juce::countNumberOfBits(static_cast<juce::uint32>(fromMask & to.mask));
+        weight += static_cast<float>(commonTones) / static_cast<float>(to.numNotes);
+
+        weight -= 0.1f * static_cast<float>(to.commonness);
+
+        return weight;
+    }
+}
+
+//==============================================================================
+ChordSuggestionEngine::ChordSuggestionEngine()
+{
+    std::vector<Target> targets;
+    std::vector<ScoredTarget> scored;
+    targets.reserve(12 * diatonicCandidateTypes.size());
+    scored.reserve(12 * diatonicCandidateTypes.size());
+
+    auto keepBest = [&scored] (EdgeList& list)
+    {
+        // Stable, so equal weights keep the degree/type order getDiatonicChords uses
+        const auto numKept = std::min(scored.size(), static_cast<size_t>(maxSuggestions));
+        std::stable_sort(scored.begin(), scored.end(),
+                         [] (const ScoredTarget& a, const ScoredTarget& b) { return a.weight > b.weight; });
+
+        list.numEdges = static_cast<int>(numKept);
+        for (size_t i = 0; i < numKept; ++i)
+            list.edges[i] = { static_cast<juce::uint8>(scored[i].target->degree), scored[i].target->type };
+    };
+
+    for (int modeIndex = 0; modeIndex < numModes; ++modeIndex)
+    {
+        const auto mode = static_cast<MusicMode>(modeIndex);
+        const auto scaleMask = getScaleMask(0, mode);
+
+        // Diatonic chords of the mode on C; every key is a transposition
+        targets.clear();
+        for (int degree = 0; degree < 12; ++degree)
+            for (size_t i = 0; i < diatonicCandidateTypes.size(); ++i)
+            {
+                const auto type = diatonicCandidateTypes[i];
+                const auto mask = getChordMask(degree, type);
+
+                if (containsPitchClass(scaleMask, degree) && isMaskSubsetOf(mask, scaleMask))
+                    targets.push_back({ degree, type, mask, getChord(type).numIntervals, static_cast<int>(i) });
+            }
+
+        // Nothing played yet: most common chord types first, tonic first
+        scored.clear();
+        for (const auto& target : targets)
+            scored.push_back({ &target, -static_cast<float>(target.commonness) });
+
+        keepBest(graph[static_cast<size_t>(getStartIndex(mode))]);
+
+        for (int fromDegree = 0; fromDegree < 12; ++fromDegree)
+            for (const auto& from : chordTable)
+            {
+                scored.clear();
+                for (const auto& target : targets)
+                    if (target.degree != fromDegree || target.type != from.type)
+                        scored.push_back({ &target, getTransitionWeight(fromDegree, from.type, target) });
+
+                keepBest(graph[static_cast<size_t>(getSourceIndex(mode, fromDegree, from.type))]);
+            }
+    }
+}
+
+int ChordSuggestionEngine::getSourceIndex(MusicMode mode, int degree, ChordType type)
+{
+    return static_cast<int>(mode) * sourcesPerMode + getPitchClass(degree) * numChordTypes + static_cast<int>(type);
+}
+
+int ChordSuggestionEngine::getStartIndex(MusicMode mode)
+{
+    return static_cast<int>(mode) * sourcesPerMode + sourcesPerMode - 1;
+}
+
+ChordSuggestionEngine::Suggestions ChordSuggestionEngine::getSuggestions(const RecognizedChord& previousChord,
+                                                                         int keyPitchClass, MusicMode mode,
+                                                                         int maxResults) const
+{
+    const int key = getPitchClass(keyPitchClass);
+    const int index = previousChord.isValid() ? getSourceIndex(mode, previousChord.root - key, previousChord.type)
+                                              : getStartIndex(mode);
+
+    const auto& list = graph[static_cast<size_t>(index)];
+
+    Suggestions result;
+    result.numItems = juce::jlimit(0, list.numEdges, maxResults);
+
+    for (int i = 0; i < result.numItems; ++i)
+    {
+        const auto& edge = list.edges[static_cast<size_t>(i)];
+        result.items[static_cast<size_t>(i)] = { getPitchClass(edge.degree + key), edge.type };
+    }
+
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "ChordRecognizer.h"
+#include "ScaleTables.h"
+
+//==============================================================================
+/*
+    Next-chord suggestions, the native version of getChordSuggestions()
+    (chord-utils.ts).
+
+    For each mode, a weighted transition graph goes from every possible previous
+    chord (scale degree x chord type) to the diatonic chords of that mode. It is
+    built once in the constructor and only the best maxSuggestions edges of each
+    chord are kept. A query is then an index lookup plus a copy of up to k
+    entries transposed to the key.
+
+    Edge weights keep the reference rules and rank around them:
+      - root up a fourth (V-I): +3.5, root up a fifth: +3
+      - relative minor after a major triad, relative major after a minor: +3
+      - root up or down a step: +1
+      - up to +1 for the share of the new chord's notes already sounding
+      - -0.1 per place down getDiatonicChords()'s type list, so common chords
+        come first
+    With no previous chord, the diatonic chords are listed most common type
+    first, starting from the tonic.
+*/
+struct ChordSuggestion
+{
+    int root = 0;                       // pitch class
+    ChordType type = ChordType::major;
+};
+
+class ChordSuggestionEngine
+{
+public:
+    static constexpr int maxSuggestions = 8;
+
+    struct Suggestions
+    {
+        std::array<ChordSuggestion, maxSuggestions> items {};
+        int numItems = 0;
+
+        const ChordSuggestion* begin() const    { return items.data(); }
+        const ChordSuggestion* end() const      { return items.data() + numItems; }
+        int size() const                        { return numItems; }
+    };
+
+    ChordSuggestionEngine();
+
+    // Up to maxResults suggestions to follow previousChord (an invalid chord means
+    // nothing has been played yet). Doesn't allocate.
+    Suggestions getSuggestions(const RecognizedChord& previousChord, int keyPitchClass, MusicMode mode,
+                               int maxResults = maxSuggestions) const;
+
+private:
+    struct Edge
+    {
+        juce::uint8 degree = 0;         // semitones above the key
+        ChordType type = ChordType::major;
+    };
+
+    struct EdgeList
+    {
+        std::array<Edge, maxSuggestions> edges {};
+        int numEdges = 0;
+    };
+
+    // One list per previous (degree, type), plus one for no previous chord
+    static constexpr int sourcesPerMode = 12 * numChordTypes + 1;
+
+    static int getSourceIndex(MusicMode mode, int degree, ChordType type);
+    static int getStartIndex(MusicMode mode);
+
+    std::array<EdgeList, static_cast<size_t>(numModes * sourcesPerMode)> graph;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChordSuggestionEngine)
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <initializer_list>
+
+//==============================================================================
+/*
+    Compile-time port of chordIntervals (chord-utils.ts).
+
+    Each chord type stores its intervals above the root and a 12-bit pitch-class
+    mask (bit n set = n semitones above the root, modulo 12). Building a chord is
+    a copy of at most six bytes, transposing a mask is a 12-bit rotate, and
+    testing whether a chord fits a scale is a single AND, so key taps and
+    diatonic filtering never allocate.
+
+    Types are listed in ALL_CHORD_TYPES order (PianoXL.tsx), which is also the
+    order chord types cycle through on a key. 'bass' and 'user' aren't listed:
+    the bass note is played by BassSampler, and user chords aren't supported yet.
+*/
+enum class ChordType : juce::uint8
+{
+    // Triads
+    major, minor, diminished, augmented, power,
+
+    // 7th chords
+    major7, major7Alt, minor7, dominant7, diminished7, minor7Flat5, halfDiminished7, minorMajor7,
+
+    // 9th chords
+    major9, minor9, dominant9, add9, dominant7Flat9, dominant7Sharp9, diminished9, augmented9,
+
+    // 11th & 13th chords
+    dominant11, minor11, major11, dominant13, dominant13Sus, dominant13Flat9, minor11Flat5,
+
+    // Sus chords
+    sus2, sus4, dominant7Sus, dominant7Sus4, dominant9Sus, dominant7Sus2Flat9,
+
+    // 6th chords
+    major6, minor6, sixNine, minorSixNine,
+
+    // Altered chords
+    dominant7Sharp11, dominant7Flat13, major9Sharp11, minor9Flat5, dominant9Sharp11,
+    major7Sharp5, dominant7Alt, dominant7Flat5, dominant7Sharp5, augmented7, augmentedMajor7
+};
+
+struct ChordDescriptor
+{
+    static constexpr int maxIntervals = 6;
+
+    ChordType type;
+    const char* id;         // chordIntervals key
+    const char* suffix;     // appended to the root by getChordName() (PianoXL.tsx)
+    std::array<juce::uint8, maxIntervals> intervals;
+    int numIntervals;
+    juce::uint16 mask;
+};
+
+namespace ChordTableHelpers
+{
+    constexpr ChordDescriptor chord(ChordType type, const char* id, const char* suffix,
+                                    std::initializer_list<int> intervals)
+    {
+        ChordDescriptor descriptor { type, id, suffix, {}, 0, 0 };
+
+        for (auto interval : intervals)
+        {
+            descriptor.intervals[static_cast<size_t>(descriptor.numIntervals++)] = static_cast<juce::uint8>(interval);
+            descriptor.mask = static_cast<juce::uint16>(descriptor.mask | (1 << (interval % 12)));
+        }
+
+        return descriptor;
+    }
+}
+
+inline constexpr std::array<ChordDescriptor, 49> chordTable
+{{
+    ChordTableHelpers::chord(ChordType::major,              "major",           "",         { 0, 4, 7 }),
+    ChordTableHelpers::chord(ChordType::minor,              "minor",           "m",        { 0, 3, 7 }),
+    ChordTableHelpers::chord(ChordType::diminished,         "dim",             "dim",      { 0, 3, 6 }),
+    ChordTableHelpers::chord(ChordType::augmented,          "augmented",       "aug",      { 0, 4, 8 }),
+    ChordTableHelpers::chord(ChordType::power,              "5",               "5",        { 0, 7 }),
+
+    ChordTableHelpers::chord(ChordType::major7,             "major7",          "maj7",     { 0, 4, 7, 11 }),
+    ChordTableHelpers::chord(ChordType::major7Alt,          "M7",              "M7",       { 0, 4, 7, 11 }),
+    ChordTableHelpers::chord(ChordType::minor7,             "minor7",          "m7",       { 0, 3, 7, 10 }),
+    ChordTableHelpers::chord(ChordType::dominant7,          "7",               "7",        { 0, 4, 7, 10 }),
+    ChordTableHelpers::chord(ChordType::diminished7,        "dim7",            "dim7",     { 0, 3, 6, 9 }),
+    ChordTableHelpers::chord(ChordType::minor7Flat5,        "m7b5",            "m7b5",     { 0, 3, 6, 10 }),
+    ChordTableHelpers::chord(ChordType::halfDiminished7,    "\xcf\x86" "7",    "\xcf\x86" "7", { 0, 3, 6, 10 }), // φ7, UTF-8
+    ChordTableHelpers::chord(ChordType::minorMajor7,        "minorMajor7",     "mMaj7",    { 0, 3, 7, 11 }),
+
+    ChordTableHelpers::chord(ChordType::major9,             "major9",          "maj9",     { 0, 4, 7, 11, 14 }),
+    ChordTableHelpers::chord(ChordType::minor9,             "minor9",          "m9",       { 0, 3, 7, 10, 14 }),
+    ChordTableHelpers::chord(ChordType::dominant9,          "9",               "9",        { 0, 4, 7, 10, 14 }),
+    ChordTableHelpers::chord(ChordType::add9,               "add9",            "add9",     { 0, 4, 7, 14 }),
+    ChordTableHelpers::chord(ChordType::dominant7Flat9,     "7b9",             "7b9",      { 0, 4, 7, 10, 13 }),
+    ChordTableHelpers::chord(ChordType::dominant7Sharp9,    "7#9",             "7#9",      { 0, 4, 7, 10, 15 }),
+    ChordTableHelpers::chord(ChordType::diminished9,        "dim9",            "dim9",     { 0, 3, 6, 9, 14 }),
+    ChordTableHelpers::chord(ChordType::augmented9,         "aug9",            "aug9",     { 0, 4, 8, 10, 14 }),
+
+    ChordTableHelpers::chord(ChordType::dominant11,         "11",              "11",       { 0, 4, 7, 10, 14, 17 }),
+    ChordTableHelpers::chord(ChordType::minor11,            "m11",             "m11",      { 0, 3, 7, 10, 14, 17 }),
+    ChordTableHelpers::chord(ChordType::major11,            "major11",         "maj11",    { 0, 4, 7, 11, 14, 17 }),
+    ChordTableHelpers::chord(ChordType::dominant13,         "13",              "13",       { 0, 4, 7, 10, 14, 21 }),
+    ChordTableHelpers::chord(ChordType::dominant13Sus,      "13sus",           "13sus",    { 0, 5, 7, 10, 14, 21 }),
+    ChordTableHelpers::chord(ChordType::dominant13Flat9,    "13b9",            "13b9",     { 0, 4, 7, 10, 13, 21 }),
+    ChordTableHelpers::chord(ChordType::minor11Flat5,       "m11b5",           "m11b5",    { 0, 3, 6, 10, 14, 17 }),
+
+    ChordTableHelpers::chord(ChordType::sus2,               "sus2",            "sus2",     { 0, 2, 7 }),
+    ChordTableHelpers::chord(ChordType::sus4,               "sus4",            "sus4",     { 0, 5, 7 }),
+    ChordTableHelpers::chord(ChordType::dominant7Sus,       "7sus",            "7sus",     { 0, 5, 7, 10 }),
+    ChordTableHelpers::chord(ChordType::dominant7Sus4,      "7sus4",           "7sus4",    { 0, 5, 7, 10 }),
+    ChordTableHelpers::chord(ChordType::dominant9Sus,       "9sus",            "9sus",     { 0, 5, 7, 10, 14 }),
+    ChordTableHelpers::chord(ChordType::dominant7Sus2Flat9, "7sus2b9",         "7sus2b9",  { 0, 2, 7, 10, 13 }),
+
+    ChordTableHelpers::chord(ChordType::major6,             "6",               "6",        { 0, 4, 7, 9 }),
+    ChordTableHelpers::chord(ChordType::minor6,             "minor6",          "m6",       { 0, 3, 7, 9 }),
+    ChordTableHelpers::chord(ChordType::sixNine,            "69",              "69",       { 0, 4, 7, 9, 14 }),
+    ChordTableHelpers::chord(ChordType::minorSixNine,       "m69",             "m69",      { 0, 3, 7, 9, 14 }),
+
+    ChordTableHelpers::chord(ChordType::dominant7Sharp11,   "7#11",            "7#11",     { 0, 4, 7, 10, 18 }),
+    ChordTableHelpers::chord(ChordType::dominant7Flat13,    "7b13",            "7b13",     { 0, 4, 7, 10, 20 }),
+    ChordTableHelpers::chord(ChordType::major9Sharp11,      "maj9#11",         "maj9#11",  { 0, 4, 7, 11, 14, 18 }),
+    ChordTableHelpers::chord(ChordType::minor9Flat5,        "m9b5",            "m9b5",     { 0, 3, 6, 10, 14 }),
+    ChordTableHelpers::chord(ChordType::dominant9Sharp11,   "9#11",            "9#11",     { 0, 4, 7, 10, 14, 18 }),
+    ChordTableHelpers::chord(ChordType::major7Sharp5,       "maj7#5",          "maj7#5",   { 0, 4, 8, 11 }),
+    ChordTableHelpers::chord(ChordType::dominant7Alt,       "7alt",            "7alt",     { 0, 4, 8, 10, 15, 21 }),
+    ChordTableHelpers::chord(ChordType::dominant7Flat5,     "7b5",             "7b5",      { 0, 4, 6, 10 }),
+    ChordTableHelpers::chord(ChordType::dominant7Sharp5,    "7#5",             "7#5",      { 0, 4, 8, 10 }),
+    ChordTableHelpers::chord(ChordType::augmented7,         "augmented7",      "aug7",     { 0, 4, 8, 10 }),
+    ChordTableHelpers::chord(ChordType::augmentedMajor7,    "augmentedMajor7", "augMaj7",  { 0, 4, 8, 11 })
+}};
+
+inline constexpr int numChordTypes = static_cast<int>(chordTable.size());
+
+constexpr const ChordDescriptor& getChord(ChordType type)
+{
+    return chordTable[static_cast<size_t>(type)];
+}
+
+// The table is indexed by the enum, so the two must stay in the same order
+constexpr bool chordTableMatchesEnum()
+{
+    for (size_t i = 0; i < chordTable.size(); ++i)
+        if (static_cast<size_t>(chordTable[i].type) != i)
+            return false;
+    return true;
+}
+
+static_assert(chordTableMatchesEnum(), "chordTable must be in ChordType order");
+static_assert(getChord(ChordType::dominant7).mask == 0b010010010001, "C7 is C, E, G, Bb");
+
+//==============================================================================
+// Pitch-class helpers. A pitch-class mask has bit n set for note n (C = 0).
+
+// noteNames (chord-utils.ts)
+inline constexpr std::array<const char*, 12> pitchClassNames
+{{
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+}};
+
+constexpr int getPitchClass(int midiNote)
+{
+    return ((midiNote % 12) + 12) % 12;
+}
+
+// Rotates a mask up by a number of semitones (negative = down)
+constexpr juce::uint16 transposeMask(juce::uint16 mask, int semitones)
+{
+    const int shift = getPitchClass(semitones);
+    return static_cast<juce::uint16>(((mask << shift) | (mask >> (12 - shift))) & 0xfff);
+}
+
+// Pitch classes of a chord built on rootPitchClass
+constexpr juce::uint16 getChordMask(int rootPitchClass, ChordType type)
+{
+    return transposeMask(getChord(type).mask, rootPitchClass);
+}
+
+// True when every pitch class of the chord is also in the other mask (e.g. a scale)
+constexpr bool isMaskSubsetOf(juce::uint16 chordMask, juce::uint16 containingMask)
+{
+    return (chordMask & ~containingMask) == 0;
+}
+
+constexpr bool containsPitchClass(juce::uint16 mask, int midiNote)
+{
+    return (mask & (1 << getPitchClass(midiNote))) != 0;
+}
+
+static_assert(transposeMask(getChord(ChordType::major).mask, 7) == getChordMask(7, ChordType::major), "");
+static_assert(getChordMask(9, ChordType::minor) == ((1 << 9) | (1 << 0) | (1 << 4)), "A minor is A, C, E");
+
+//==============================================================================
+/*
+    The MIDI notes of a chord, held by value. Iterable, so it can be passed
+    straight to AudioEngine::triggerChordFromUI().
+*/
+struct ChordNotes
+{
+    std::array<juce::uint8, ChordDescriptor::maxIntervals> notes {};
+    int numNotes = 0;
+
+    constexpr const juce::uint8* begin() const  { return notes.data(); }
+    constexpr const juce::uint8* end() const    { return notes.data() + numNotes; }
+    constexpr int size() const                  { return numNotes; }
+};
+
+// getChordNotes() without the bass note: the chord's MIDI notes above rootMidiNote
+constexpr ChordNotes buildChord(int rootMidiNote, ChordType type)
+{
+    const auto& chord = getChord(type);
+    ChordNotes result;
+
+    for (int i = 0; i < chord.numIntervals; ++i)
+    {
+        const int note = rootMidiNote + chord.intervals[static_cast<size_t>(i)];
+        if (note >= 0 && note <= 127)
+            result.notes[static_cast<size_t>(result.numNotes++)] = static_cast<juce::uint8>(note);
+    }
+
+    return result;
+}
@@ -0,0 +1,171 @@
+#include "ClickSampleBank.h"
+#include "SoundResources.h"
+#include <iostream>
+
+ClickSampleBank::ClickSampleBank()
+{
+    prepare(sampleRate);
+}
+
+void ClickSampleBank::loadSamples()
+{
+    static const char* const fileNames[numClickSamples] = { "one.mp3", "two.mp3", "three.mp3", "four.mp3", "CLICK7.mp3" };
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    juce::StringArray missing;
+
+    for (int i = 0; i < numClickSamples; ++i)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        if (auto stream = SoundResources::open("click-voice", fileNames[i]))
+            reader.reset(formatManager.createReaderFor(std::move(stream)));
+
+        auto& sample = decoded[static_cast<size_t>(i)];
+
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+        {
+            missing.add(fileNames[i]);
+            sample.data.setSize(0, 0);
+            continue;
+        }
+
+        // playClick starts "four" 0.5 ms in
+        const int skip = i == 3 ? juce::roundToInt(0.0005 * reader->sampleRate) : 0;
+        const int length = static_cast<int>(reader->lengthInSamples) - skip;
+
+        juce::AudioBuffer<float> source(static_cast<int>(reader->numChannels), length);
+        reader->read(&source, 0, length, skip, true, true);
+
+        sample.data.setSize(1, length);
+        sample.data.clear();
+        const float channelGain = 1.0f / static_cast<float>(juce::jmax(1, source.getNumChannels()));
+        for (int channel = 0; channel < source.getNumChannels(); ++channel)
+            sample.data.addFrom(0, 0, source, channel, 0, length, channelGain);
+
+        sample.sampleRate = reader->sampleRate;
+    }
+
+    // The click-voice assets aren't shipped with every checkout; the ticks stand in for them
+    if (!missing.isEmpty())
+        std::cout << "Click samples not found (" << missing.joinIntoString(", ")
+                  << "), using synthesized ticks" << std::endl;
+}
+
+void ClickSampleBank::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    // Lay the five samples out back to back at the device rate
+    int total = 0;
+    for (int i = 0; i < numClickSamples; ++i)
+    {
+        const auto& sample = decoded[static_cast<size_t>(i)];
+        auto& region = regions[static_cast<size_t>(i)];
+
+        region.start = total;
+        region.length = sample.data.getNumSamples() > 0
+                            ? static_cast<int>(sample.data.getNumSamples() * sampleRate / sample.sampleRate)
+                            : juce::roundToInt(0.03 * sampleRate); // 30 ms synthesized tick
+        total += region.length;
+    }
+
+    bank.setSize(1, juce::jmax(1, total));
+    bank.clear();
+
+    for (int i = 0; i < numClickSamples; ++i)
+    {
+        const auto& sample = decoded[static_cast<size_t>(i)];
+        const auto& region = regions[static_cast<size_t>(i)];
+        float* destination = bank.getWritePointer(0, region.start);
+
+        if (sample.data.getNumSamples() == 0)
+        {
+            synthesizeTick(i, destination, region.length);
+        }
+        else if (sample.sampleRate == sampleRate)
+        {
+            bank.copyFrom(0, region.start, sample.data, 0, 0, region.length);
+        }
+        else
+        {
+            // One-off conversion; stop a few samples short so the interpolator stays in range
+            juce::LagrangeInterpolator resampler;
+            const double ratio = sample.sampleRate / sampleRate;
+            const int available = juce::jmax(0, juce::jmin(region.length,
+                                                           static_cast<int>((sample.data.getNumSamples() - 4) / ratio)));
+            resampler.process(ratio, sample.data.getReadPointer(0), destination, available);
+        }
+    }
+
+    stop();
+}
+
+void ClickSampleBank::synthesizeTick(int sample, float* destination, int length) const
+{
+    // Spoken counts become pitched ticks with an accented downbeat; CLICK7 is a short noise burst
+    const double frequency = sample == 0 ? 1500.0 : 1000.0;
+    const double decay = std::pow(0.001, 1.0 / juce::jmax(1, length));
+    juce::Random random(1234);
+    double level = 1.0;
+
+    for (int i = 0; i < length; ++i)
+    {
+        destination[i] = sample == click7
+                            ? static_cast<float>(level * 0.5 * (random.nextFloat() * 2.0f - 1.0f))
+                            : static_cast<float>(level * std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+        level *= decay;
+    }
+}
+
+void ClickSampleBank::trigger(int clickNumber)
+{
+    startPlayhead(juce::jlimit(1, numCounts, clickNumber) - 1);
+    startPlayhead(click7);
+}
+
+void ClickSampleBank::startPlayhead(int sample)
+{
+    // Reuse an idle playhead, or the one furthest through its sample
+    Playhead* chosen = &playheads[0];
+    for (auto& playhead : playheads)
+    {
+        if (playhead.sample < 0)
+        {
+            chosen = &playhead;
+            break;
+        }
+
+        if (playhead.position > chosen->position)
+            chosen = &playhead;
+    }
+
+    chosen->sample = sample;
+    chosen->position = 0;
+}
+
+void ClickSampleBank::stop()
+{
+    for (auto& playhead : playheads)
+        playhead.sample = -1;
+}
+
+void ClickSampleBank::render(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    for (auto& playhead : playheads)
+    {
+        if (playhead.sample < 0)
+            continue;
+
+        const auto& region = regions[static_cast<size_t>(playhead.sample)];
+        const int count = juce::jmin(numSamples, region.length - playhead.position);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.addFrom(channel, startSample, bank, 0, region.start + playhead.position, count, gain);
+
+        playhead.position += count;
+        if (playhead.position >= region.length)
+            playhead.sample = -1;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/*
+    Metronome sounds for the progression player, replacing playClick() in
+    audio-utils.ts.
+
+    The reference creates two sound objects per beat: the spoken count
+    (one..four.mp3) and CLICK7.mp3. Here all five samples are decoded once at
+    startup. prepare() converts them to the device rate and packs them into a
+    single buffer. A beat then just starts two playheads into that buffer, at the
+    sample position the sequencer hands over, so counting in never decodes or
+    allocates.
+
+    Samples that can't be found or read are replaced by short synthesized ticks,
+    so the metronome still works without the asset folder.
+*/
+class ClickSampleBank
+{
+public:
+    static constexpr int numCounts = 4;
+
+    ClickSampleBank();
+
+    // Message thread, before audio starts: decodes one..four.mp3 and CLICK7.mp3 from
+    // click-voice (see SoundResources)
+    void loadSamples();
+
+    // Converts the decoded samples to the device rate and packs them into the bank
+    void prepare(double newSampleRate);
+
+    // Audio thread: plays the count for beat 1-4 together with the click
+    void trigger(int clickNumber);
+    void stop();
+
+    // Adds the sounding clicks into the given region of the buffer
+    void render(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    static constexpr int click7 = numCounts;
+    static constexpr int numClickSamples = numCounts + 1;
+    static constexpr int maxPlayheads = 8;
+
+    // Click volume from loadClickSound()
+    static constexpr float gain = 0.2f;
+
+    struct DecodedSample
+    {
+        juce::AudioBuffer<float> data; // mono, empty if the file couldn't be read
+        double sampleRate = 44100.0;
+    };
+
+    struct Region
+    {
+        int start = 0;
+        int length = 0;
+    };
+
+    struct Playhead
+    {
+        int sample = -1; // -1 when idle
+        int position = 0;
+    };
+
+    void startPlayhead(int sample);
+    void synthesizeTick(int sample, float* destination, int length) const;
+
+    std::array<DecodedSample, numClickSamples> decoded;
+
+    juce::AudioBuffer<float> bank;
+    std::array<Region, numClickSamples> regions;
+    std::array<Playhead, maxPlayheads> playheads;
+    double sampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClickSampleBank)
+};
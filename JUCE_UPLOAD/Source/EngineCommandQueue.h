@@ -0,0 +1,235 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Engine parameters that can be changed from the UI
+enum class EngineParameter : juce::uint8
+{
+    chordVolume,    // verticalFader position, 0..1
+    bassVolume,     // 1 - fader position
+    sustain,        // 10..200 percent
+    tempo,          // progression BPM, also sets the flam length
+    flam,           // FlamValue as a number
+    eqLow,          // master EQ band gains in dB, -12..+12
+    eqMid,
+    eqHigh,
+    releaseModel,   // EnvelopeBank::ReleaseModel as a number: 0 = note-off, 1 = timed
+    instrument      // InstrumentType as a number (index into instrumentTable)
+};
+
+//==============================================================================
+/*
+    A single UI-to-audio message. Commands are plain values so they can be copied
+    into the ring without allocating; a chord carries its notes inline.
+*/
+struct EngineCommand
+{
+    enum class Type : juce::uint8
+    {
+        noteOn,
+        noteOff,
+        bassNoteOn,             // notes[0] = bass note, velocity = volume before bassVolume
+        chordTrigger,
+        allNotesOff,
+        parameterChange,
+        setProgressionChord,    // index = chord slot, notes = chord, bassNote = its bass (or -1), value = beats
+        setProgressionLength,   // index = number of chords
+        startProgression,
+        stopProgression,
+        playArrangement,        // index = bar to start from
+        stopArrangement,
+        setArrangementLoop,     // index = first bar, value = end bar (not after the first: no loop)
+        fingerDown,             // index = finger, notes = chord, bassNote = its bass (or -1)
+        fingerUp                // index = finger
+    };
+
+    static constexpr int maxChordNotes = 8;
+
+    Type type = Type::allNotesOff;
+    double timestampMs = 0.0;   // juce::Time::getMillisecondCounterHiRes() when posted
+
+    float velocity = 1.0f;
+    int index = 0;
+    int numNotes = 0;
+    std::array<juce::uint8, maxChordNotes> notes {};
+    int bassNote = -1;
+
+    EngineParameter parameter = EngineParameter::chordVolume;
+    float value = 0.0f;
+
+    static EngineCommand noteOn(int midiNote, float velocity)
+    {
+        EngineCommand command(Type::noteOn);
+        command.velocity = velocity;
+        command.addNote(midiNote);
+        return command;
+    }
+
+    static EngineCommand noteOff(int midiNote)
+    {
+        EngineCommand command(Type::noteOff);
+        command.addNote(midiNote);
+        return command;
+    }
+
+    static EngineCommand bassNoteOn(int midiNote, float velocity)
+    {
+        EngineCommand command(Type::bassNoteOn);
+        command.velocity = velocity;
+        command.addNote(midiNote);
+        return command;
+    }
+
+    template <typename NoteContainer>
+    static EngineCommand chordTrigger(const NoteContainer& midiNotes, float velocity)
+    {
+        EngineCommand command(Type::chordTrigger);
+        command.velocity = velocity;
+        for (auto note : midiNotes)
+            command.addNote(static_cast<int>(note));
+        return command;
+    }
+
+    static EngineCommand allNotesOff()
+    {
+        return EngineCommand(Type::allNotesOff);
+    }
+
+    static EngineCommand parameterChange(EngineParameter parameter, float value)
+    {
+        EngineCommand command(Type::parameterChange);
+        command.parameter = parameter;
+        command.value = value;
+        return command;
+    }
+
+    template <typename NoteContainer>
+    static EngineCommand setProgressionChord(int chordIndex, const NoteContainer& midiNotes,
+                                             int bassNote = -1, double beats = 4.0)
+    {
+        EngineCommand command(Type::setProgressionChord);
+        command.index = chordIndex;
+        command.bassNote = bassNote >= 0 ? juce::jlimit(0, 127, bassNote) : -1;
+        command.value = static_cast<float>(beats);
+        for (auto note : midiNotes)
+            command.addNote(static_cast<int>(note));
+        return command;
+    }
+
+    static EngineCommand setProgressionLength(int numChords)
+    {
+        EngineCommand command(Type::setProgressionLength);
+        command.index = numChords;
+        return command;
+    }
+
+    static EngineCommand startProgression()   { return EngineCommand(Type::startProgression); }
+    static EngineCommand stopProgression()    { return EngineCommand(Type::stopProgression); }
+
+    static EngineCommand playArrangement(int fromBar)
+    {
+        EngineCommand command(Type::playArrangement);
+        command.index = fromBar;
+        return command;
+    }
+
+    static EngineCommand stopArrangement()    { return EngineCommand(Type::stopArrangement); }
+
+    static EngineCommand setArrangementLoop(int startBar, int endBar)
+    {
+        EngineCommand command(Type::setArrangementLoop);
+        command.index = startBar;
+        command.value = static_cast<float>(endBar);
+        return command;
+    }
+
+    // A key held by one finger (a MouseInputSource index): the chord sounds until fingerUp
+    template <typename NoteContainer>
+    static EngineCommand fingerDown(int finger, const NoteContainer& midiNotes, int bassNote, float velocity)
+    {
+        EngineCommand command(Type::fingerDown);
+        command.index = finger;
+        command.velocity = velocity;
+        command.bassNote = bassNote >= 0 ? juce::jlimit(0, 127, bassNote) : -1;
+        for (auto note : midiNotes)
+            command.addNote(static_cast<int>(note));
+        return command;
+    }
+
+    static EngineCommand fingerUp(int finger)
+    {
+        EngineCommand command(Type::fingerUp);
+        command.index = finger;
+        return command;
+    }
+
+    EngineCommand() = default;
+
+private:
+    explicit EngineCommand(Type t)
+        : type(t), timestampMs(juce::Time::getMillisecondCounterHiRes())
+    {
+    }
+
+    void addNote(int midiNote)
+    {
+        if (numNotes < maxChordNotes)
+            notes[static_cast<size_t>(numNotes++)] = static_cast<juce::uint8>(juce::jlimit(0, 127, midiNote));
+    }
+};
+
+//==============================================================================
+/*
+    Single-producer/single-consumer ring of plain values.
+
+    One thread pushes and the other pops. Both sides are wait-free: juce::AbstractFifo
+    only uses atomic indices, and the storage is a fixed array. If the ring is full,
+    push() returns false and the item is dropped rather than blocking the producer.
+*/
+template <typename ItemType, int capacity>
+class LockFreeQueue
+{
+public:
+    LockFreeQueue() : fifo(capacity) {}
+
+    bool push(const ItemType& item)
+    {
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 > 0)
+            buffer[static_cast<size_t>(scope.startIndex1)] = item;
+        else if (scope.blockSize2 > 0)
+            buffer[static_cast<size_t>(scope.startIndex2)] = item;
+        else
+            return false;
+
+        return true;
+    }
+
+    bool pop(ItemType& item)
+    {
+        const auto scope = fifo.read(1);
+        if (scope.blockSize1 > 0)
+            item = buffer[static_cast<size_t>(scope.startIndex1)];
+        else if (scope.blockSize2 > 0)
+            item = buffer[static_cast<size_t>(scope.startIndex2)];
+        else
+            return false;
+
+        return true;
+    }
+
+    int getNumReady() const { return fifo.getNumReady(); }
+
+    // Only safe when neither thread is using the queue
+    void reset() { fifo.reset(); }
+
+private:
+    juce::AbstractFifo fifo;
+    std::array<ItemType, static_cast<size_t>(capacity)> buffer {};
+
+    JUCE_DECLARE_NON_COPYABLE(LockFreeQueue)
+};
+
+// UI-to-audio commands, posted by the message thread and drained once per block
+using EngineCommandQueue = LockFreeQueue<EngineCommand, 1024>;
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/*
+    What the engine is playing at the end of an audio block: the chord notes
+    sounding (started and not yet released), the bass note and the progression
+    chord. The UI uses it to
+    light up the sounding keys and name the current chord (onChordChange in
+    playProgression), whether the notes came from a key, a progression or
+    MIDI input.
+*/
+struct EngineStateSnapshot
+{
+    std::array<juce::uint64, 2> soundingNotes {};   // bit n = MIDI note n is sounding
+    int bassNote = -1;
+    int chordIndex = -1;            // progression chord, or -1 when not playing one
+    int stepIndex = -1;
+
+    juce::int64 samplePosition = 0; // engine sample clock at the end of the block
+    double blockStartMs = 0.0;      // juce::Time::getMillisecondCounterHiRes() when the block began
+
+    bool isSounding(int midiNote) const
+    {
+        return ((soundingNotes[static_cast<size_t>(midiNote >> 6) & 1] >> (midiNote & 63)) & 1) != 0;
+    }
+
+    bool hasNotes() const { return (soundingNotes[0] | soundingNotes[1]) != 0 || bassNote >= 0; }
+
+    // Lowest sounding chord note, or -1
+    int getLowestNote() const
+    {
+        for (int note = 0; note < 128; ++note)
+            if (isSounding(note))
+                return note;
+
+        return -1;
+    }
+
+    // Sounding chord notes folded into a pitch-class mask (bit n = pitch class n)
+    juce::uint16 getSoundingPitchClasses() const
+    {
+        juce::uint16 mask = 0;
+        for (int note = 0; note < 128; ++note)
+            if (isSounding(note))
+                mask = static_cast<juce::uint16>(mask | (1 << (note % 12)));
+
+        return mask;
+    }
+
+    // Same notes and chord; the timing fields don't count
+    bool hasSameState(const EngineStateSnapshot& other) const
+    {
+        return soundingNotes == other.soundingNotes && bassNote == other.bassNote
+            && chordIndex == other.chordIndex && stepIndex == other.stepIndex;
+    }
+};
+
+//==============================================================================
+/*
+    Audio-to-UI handover of the latest EngineStateSnapshot, double-buffered.
+
+    The audio thread writes the slot that isn't published and then publishes
+    it, so it never waits. Each slot has a sequence number that is odd while
+    it's being written. The reader copies the published slot and keeps the
+    copy only if the sequence was even and unchanged across the copy; if the
+    writer came round to that slot meanwhile, it tries again. That can only
+    happen when a whole audio block passes during one small copy, so a retry
+    is rare and quick.
+*/
+class EngineStateBuffer
+{
+public:
+    EngineStateBuffer() = default;
+
+    // Audio thread
+    void publish(const EngineStateSnapshot& snapshot)
+    {
+        const int slot = 1 - published.load(std::memory_order_relaxed);
+        auto& sequence = slots[static_cast<size_t>(slot)].sequence;
+
+        sequence.fetch_add(1, std::memory_order_relaxed);     // odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        slots[static_cast<size_t>(slot)].snapshot = snapshot;
+        sequence.fetch_add(1, std::memory_order_release);     // even: complete
+
+        published.store(slot, std::memory_order_release);
+    }
+
+    // Message thread. Returns false only before anything has been published.
+    bool read(EngineStateSnapshot& result) const
+    {
+        for (;;)
+        {
+            const auto& slot = slots[static_cast<size_t>(published.load(std::memory_order_acquire))];
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+
+            if (before == 0)
+                return false;
+
+            if ((before & 1) != 0)
+                continue;
+
+            result = slot.snapshot;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<juce::uint32> sequence { 0 };
+        EngineStateSnapshot snapshot;
+    };
+
+    std::array<Slot, 2> slots;
+    std::atomic<int> published { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(EngineStateBuffer)
+};
+
+//==============================================================================
+/*
+    Message-thread delay line that holds snapshots back by the output latency,
+    so what the keys show lines up with what comes out of the speakers. Only
+    changes are queued. If the queue fills up, the oldest change is applied
+    straight away rather than lost.
+*/
+class EngineStateDelay
+{
+public:
+    static constexpr int capacity = 16;
+
+    EngineStateDelay() = default;
+
+    void push(const EngineStateSnapshot& snapshot)
+    {
+        if (snapshot.hasSameState(lastQueued))
+            return;
+
+        lastQueued = snapshot;
+
+        if (count == capacity)
+        {
+            current = pending[static_cast<size_t>(first)];
+            first = (first + 1) % capacity;
+            --count;
+        }
+
+        pending[static_cast<size_t>((first + count) % capacity)] = snapshot;
+        ++count;
+    }
+
+    // Applies every snapshot heard by nowMs; returns true if the state changed since the last call
+    bool update(double nowMs, double latencyMs)
+    {
+        while (count > 0 && pending[static_cast<size_t>(first)].blockStartMs + latencyMs <= nowMs)
+        {
+            current = pending[static_cast<size_t>(first)];
+            first = (first + 1) % capacity;
+            --count;
+        }
+
+        if (current.hasSameState(lastReported))
+            return false;
+
+        lastReported = current;
+        return true;
+    }
+
+    const EngineStateSnapshot& getCurrent() const { return current; }
+
+private:
+    std::array<EngineStateSnapshot, capacity> pending;
+    int first = 0;
+    int count = 0;
+
+    EngineStateSnapshot lastQueued, current, lastReported;
+
+    JUCE_DECLARE_NON_COPYABLE(EngineStateDelay)
+};
@@ -0,0 +1,182 @@
+#include "EnvelopeBank.h"
+
+EnvelopeBank::EnvelopeBank()
+{
+    prepare(sampleRate, 512);
+}
+
+void EnvelopeBank::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = maximumBlockSize;
+
+    // One row of gains per voice. Rows start on a SIMD boundary and are padded to a
+    // whole number of registers so every row stays aligned.
+    constexpr size_t lanes = Vec::SIMDNumElements;
+    rowStride = (static_cast<size_t>(maximumBlockSize) + lanes - 1) / lanes * lanes;
+    gainStorage.calloc(rowStride * maxVoices + lanes);
+    gainRows = Vec::getNextSIMDAlignedPtr(gainStorage.get());
+
+    for (int voice = 0; voice < maxVoices; ++voice)
+        kill(voice);
+
+    updateCoefficients();
+}
+
+void EnvelopeBank::setSustain(float sustainPercent)
+{
+    sustain = juce::jlimit(10.0f, 200.0f, sustainPercent);
+    updateCoefficients();
+}
+
+void EnvelopeBank::updateCoefficients()
+{
+    // Held notes fall to -60 dB over 2 seconds at 100% sustain (the ramp length used
+    // by playChord), released notes fall by 40 dB over 0.5 seconds like stopNote.
+    const double decaySeconds = 2.0 * sustain / 100.0;
+    const double releaseSeconds = 0.5;
+
+    decayCoeff = static_cast<float>(std::pow(0.001, 1.0 / (decaySeconds * sampleRate)));
+    releaseCoeff = static_cast<float>(std::pow(0.01, 1.0 / (releaseSeconds * sampleRate)));
+    timedHoldSamples = juce::roundToInt(sustain * 0.1 * sampleRate);
+}
+
+void EnvelopeBank::start(int voice, float peakLevel)
+{
+    const auto v = static_cast<size_t>(voice);
+    level[v] = peakLevel;
+    target[v] = 0.0f;
+    stage[v] = Stage::held;
+    holdRemaining[v] = timedHoldSamples;
+}
+
+void EnvelopeBank::release(int voice)
+{
+    const auto v = static_cast<size_t>(voice);
+    if (stage[v] == Stage::held)
+        stage[v] = Stage::release;
+}
+
+void EnvelopeBank::kill(int voice)
+{
+    const auto v = static_cast<size_t>(voice);
+    level[v] = 0.0f;
+    target[v] = 0.0f;
+    stage[v] = Stage::idle;
+    holdRemaining[v] = 0;
+    audibleSamples[v] = 0;
+}
+
+int EnvelopeBank::getNumActive() const
+{
+    int count = 0;
+    for (auto s : stage)
+        if (s != Stage::idle)
+            ++count;
+    return count;
+}
+
+void EnvelopeBank::process(int numSamples)
+{
+    jassert(numSamples <= maxBlockSize);
+    numSamples = juce::jmin(numSamples, maxBlockSize);
+
+    for (size_t v = 0; v < static_cast<size_t>(maxVoices); ++v)
+    {
+        audibleSamples[v] = 0;
+
+        float* out = gainRows + v * rowStride;
+        int done = 0;
+
+        while (done < numSamples && stage[v] != Stage::idle)
+        {
+            const bool held = stage[v] == Stage::held;
+            int segment = numSamples - done;
+
+            if (held && releaseModel == ReleaseModel::timed)
+                segment = juce::jmin(segment, holdRemaining[v]);
+
+            const int audible = renderSegment(v, out + done, segment, held ? decayCoeff : releaseCoeff);
+            done += audible;
+
+            if (audible < segment)
+            {
+                // Crossed the silence threshold: free the voice at this exact sample
+                stage[v] = Stage::idle;
+                level[v] = 0.0f;
+                break;
+            }
+
+            if (held && releaseModel == ReleaseModel::timed)
+            {
+                holdRemaining[v] -= segment;
+                if (holdRemaining[v] <= 0)
+                    stage[v] = Stage::release;
+            }
+        }
+
+        audibleSamples[v] = done;
+    }
+}
+
+int EnvelopeBank::renderSegment(size_t voice, float* out, int numSamples, float coeff)
+{
+    const float t = target[voice];
+    float deviation = level[voice] - t;
+
+    // Work out where a decaying tail drops below the threshold and stop there
+    int length = numSamples;
+    if (t == 0.0f && coeff < 1.0f)
+    {
+        const float magnitude = std::abs(deviation);
+
+        if (magnitude <= silenceThreshold)
+            return 0;
+
+        const double crossing = std::ceil(std::log(silenceThreshold / magnitude) / std::log(static_cast<double>(coeff)));
+        if (crossing < numSamples)
+            length = static_cast<int>(crossing);
+    }
+
+    int i = 0;
+
+    // Scalar until the output is register-aligned
+    for (; i < length && !Vec::isSIMDAligned(out + i); ++i)
+    {
+        out[i] = t + deviation;
+        deviation *= coeff;
+    }
+
+    constexpr int lanes = static_cast<int>(Vec::SIMDNumElements);
+
+    if (length - i >= lanes)
+    {
+        alignas(Vec::SIMDRegisterSize) float powers[lanes];
+        float power = 1.0f;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            powers[lane] = power;
+            power *= coeff; // ends as coeff^lanes
+        }
+
+        auto deviations = Vec::fromRawArray(powers) * deviation;
+        const auto targets = Vec::expand(t);
+
+        for (; i + lanes <= length; i += lanes)
+        {
+            (deviations + targets).copyToRawArray(out + i);
+            deviations = deviations * power;
+        }
+
+        deviation = deviations.get(0);
+    }
+
+    for (; i < length; ++i)
+    {
+        out[i] = t + deviation;
+        deviation *= coeff;
+    }
+
+    level[voice] = t + deviation;
+    return length;
+}
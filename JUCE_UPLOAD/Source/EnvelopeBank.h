@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/*
+    Amplitude envelopes for every voice in the pool, stored as parallel arrays
+    (structure of arrays) and advanced together once per block.
+
+    Each segment is an exponential approach to a target. Within a segment the
+    gain at sample n is target + (level - target) * coeff^n, so a voice's block of
+    gains is produced SIMD-wide: a register of successive powers is scaled by
+    coeff^lanes per step. No per-sample multiply chain is needed.
+
+    A voice is freed at the exact sample where its tail crosses the silence
+    threshold. It never decays into denormals, and only the samples before that
+    point need an oscillator. Idle voices are skipped entirely.
+
+    The release model selects what ends the held segment. noteOff releases on the
+    note-off, like stopNote(). timed releases after sustain * 100 ms, like the
+    unload timers in playChord/playBassNote.
+*/
+class EnvelopeBank
+{
+public:
+    static constexpr int maxVoices = 32;
+
+    enum class ReleaseModel
+    {
+        noteOff,
+        timed
+    };
+
+    EnvelopeBank();
+
+    void prepare(double newSampleRate, int maximumBlockSize);
+
+    // Sustain in percent (10-200) from setSustain(); sets decay time and timed hold length
+    void setSustain(float sustainPercent);
+    void setReleaseModel(ReleaseModel newModel) { releaseModel = newModel; }
+
+    void start(int voice, float peakLevel);
+    void release(int voice);
+    void kill(int voice);
+
+    bool isActive(int voice) const      { return stage[static_cast<size_t>(voice)] != Stage::idle; }
+    bool isReleasing(int voice) const   { return stage[static_cast<size_t>(voice)] == Stage::release; }
+    float getLevel(int voice) const     { return level[static_cast<size_t>(voice)]; }
+
+    // Computes the next numSamples gains for every active voice. Voices that fall
+    // silent during the block become idle afterwards.
+    void process(int numSamples);
+
+    // Results of the last process() call: per-voice gains and how many of them are audible
+    const float* getGains(int voice) const  { return gainRows + static_cast<size_t>(voice) * rowStride; }
+    int getAudibleSamples(int voice) const  { return audibleSamples[static_cast<size_t>(voice)]; }
+
+    int getNumActive() const;
+
+private:
+    enum class Stage : juce::uint8
+    {
+        idle,
+        held,
+        release
+    };
+
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    void updateCoefficients();
+
+    // Fills out[0..numSamples) for one segment and returns how many samples stayed audible
+    int renderSegment(size_t voice, float* out, int numSamples, float coeff);
+
+    // Structure of arrays, one slot per voice
+    alignas(16) std::array<float, maxVoices> level {};
+    alignas(16) std::array<float, maxVoices> target {};
+    std::array<Stage, maxVoices> stage {};
+    std::array<int, maxVoices> holdRemaining {};
+    std::array<int, maxVoices> audibleSamples {};
+
+    juce::HeapBlock<float> gainStorage;
+    float* gainRows = nullptr;
+    size_t rowStride = 0;
+    int maxBlockSize = 0;
+
+    double sampleRate = 44100.0;
+    float sustain = 100.0f;
+    float decayCoeff = 1.0f;
+    float releaseCoeff = 1.0f;
+    int timedHoldSamples = 0;
+    ReleaseModel releaseModel = ReleaseModel::noteOff;
+
+    static constexpr float silenceThreshold = 1.0e-4f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EnvelopeBank)
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "RepaintBatcher.h"
 
 class IconButton : public juce::Button
 {
@@ -10,6 +11,9 @@ public:
         setClickingTogglesState(false);
     }
 
+    // Routes the setters' repaints through the window's batcher; null repaints directly
+    void setRepaintBatcher(RepaintBatcher* newBatcher) { repaintBatcher = newBatcher; }
+
     void setIcon(const juce::String& iconPath)
     {
         if (juce::File::isAbsolutePath(iconPath))
@@ -22,7 +26,7 @@ public:
         }
         if (icon.isValid())
             icon = icon.rescaled(24, 24, juce::Graphics::highResamplingQuality); // Set a reasonable default size
-        repaint();
+        RepaintBatcher::repaint(repaintBatcher, *this);
     }
 
     void setIconText(const juce::String& text, const juce::Colour& colour)
@@ -30,25 +34,28 @@ public:
         iconText = text;
         textColour = colour;
         icon = juce::Image(); // Clear any image
-        repaint();
+        RepaintBatcher::repaint(repaintBatcher, *this);
     }
 
     void setIconColour(juce::Colour colour)
     {
         iconColour = colour;
-        repaint();
+        RepaintBatcher::repaint(repaintBatcher, *this);
     }
 
     void setBackgroundColour(juce::Colour colour)
     {
         backgroundColour = colour;
-        repaint();
+        RepaintBatcher::repaint(repaintBatcher, *this);
     }
 
     void setBorderColour(juce::Colour colour)
     {
-        borderColour = colour;
-        repaint();
+        if (borderColour != colour)
+        {
+            borderColour = colour;
+            RepaintBatcher::repaint(repaintBatcher, *this);
+        }
     }
 
 protected:
@@ -97,6 +104,7 @@ private:
     juce::Colour iconColour = juce::Colours::white;
     juce::Colour backgroundColour = juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.5f);
     juce::Colour borderColour = juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.15f);
+    RepaintBatcher* repaintBatcher = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IconButton)
 }; 
\ No newline at end of file
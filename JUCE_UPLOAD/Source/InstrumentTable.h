@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/*
+    Compile-time description of the playable instruments. The instrument selector
+    lists them in this order, and VoicePool instantiates one oscillator kernel per
+    entry, so adding an instrument here is all it takes to add it everywhere.
+
+    Waveforms follow the currentInstrument switch in playNote() (audio-utils.ts).
+    MIDI programs are the General MIDI patches (zero-based) used on export;
+    balafon keeps the 108 that exportProgressionToMidi() hard-coded.
+    Bass isn't listed: it's played by BassSampler, not selected here.
+*/
+enum class Waveform : juce::uint8
+{
+    sine,
+    triangle,
+    saw
+};
+
+enum class InstrumentType : juce::uint8
+{
+    balafon,
+    piano,
+    rhodes,
+    pluck,
+    pad,
+    steelDrum
+};
+
+struct InstrumentDescriptor
+{
+    InstrumentType type;
+    const char* label;  // instrumentSelector text
+    Waveform waveform;
+    juce::uint8 midiProgram;
+};
+
+inline constexpr std::array<InstrumentDescriptor, 6> instrumentTable
+{{
+    { InstrumentType::balafon,    "BALAFON",    Waveform::sine,     108 },  // Kalimba
+    { InstrumentType::piano,      "PIANO",      Waveform::triangle, 0 },    // Acoustic Grand Piano
+    { InstrumentType::rhodes,     "RHODES",     Waveform::sine,     4 },    // Electric Piano 1
+    { InstrumentType::pluck,      "PLUCK",      Waveform::saw,      45 },   // Pizzicato Strings
+    { InstrumentType::pad,        "PAD",        Waveform::sine,     88 },   // Pad 1 (New Age)
+    { InstrumentType::steelDrum,  "STEEL DRUM", Waveform::triangle, 114 }   // Steel Drums
+}};
+
+inline constexpr int numInstruments = static_cast<int>(instrumentTable.size());
+
+// General MIDI Electric Bass (finger), for BassSampler's notes on export
+inline constexpr juce::uint8 bassMidiProgram = 33;
+
+constexpr const InstrumentDescriptor& getInstrument(InstrumentType type)
+{
+    return instrumentTable[static_cast<size_t>(type)];
+}
+
+// The table is indexed by the enum, so the two must stay in the same order
+constexpr bool instrumentTableMatchesEnum()
+{
+    for (size_t i = 0; i < instrumentTable.size(); ++i)
+        if (static_cast<size_t>(instrumentTable[i].type) != i)
+            return false;
+    return true;
+}
+
+static_assert(instrumentTableMatchesEnum(), "instrumentTable must be in InstrumentType order");
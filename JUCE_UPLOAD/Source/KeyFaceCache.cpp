@@ -0,0 +1,135 @@
+#include "KeyFaceCache.h"
+
+namespace
+{
+    constexpr float cornerRadius = 15.0f;
+    constexpr float borderThickness = 2.0f;     // styles.keyInScale and styles.blackKey
+    constexpr float textPaddingBottom = 10.0f;
+    constexpr float fontSize = 17.6f;
+}
+
+//==============================================================================
+bool KeyFace::operator==(const KeyFace& other) const
+{
+    return width == other.width && height == other.height && scale == other.scale
+        && black == other.black && inScale == other.inScale && sounding == other.sounding && numSections == other.numSections
+        && highlightedSection == other.highlightedSection && pressed == other.pressed
+        && labels == other.labels;
+}
+
+size_t KeyFaceCache::FaceHash::operator()(const KeyFace& face) const
+{
+    auto hash = static_cast<juce::uint64>(face.width)
+              | static_cast<juce::uint64>(face.height) << 16
+              | static_cast<juce::uint64>(juce::roundToInt(face.scale * 100.0f)) << 32
+              | static_cast<juce::uint64>(face.black) << 48
+              | static_cast<juce::uint64>(face.inScale) << 49
+              | static_cast<juce::uint64>(face.pressed) << 50
+              | static_cast<juce::uint64>(face.sounding) << 51
+              | static_cast<juce::uint64>(face.numSections) << 52
+              | static_cast<juce::uint64>(face.highlightedSection + 1) << 56;
+
+    for (const auto& label : face.labels)
+        hash = hash * 31 + static_cast<juce::uint64>(label.hashCode64());
+
+    return static_cast<size_t>(hash);
+}
+
+//==============================================================================
+KeyFaceCache::KeyFaceCache()
+{
+    faces.reserve(maxFaces);
+}
+
+void KeyFaceCache::clear()
+{
+    faces.clear();
+}
+
+const juce::Image& KeyFaceCache::getImage(const KeyFace& face)
+{
+    const auto existing = faces.find(face);
+    if (existing != faces.end())
+        return existing->second;
+
+    if (faces.size() >= maxFaces)
+        faces.clear();
+
+    juce::Image image(juce::Image::ARGB,
+                      juce::jmax(1, juce::roundToInt(static_cast<float>(face.width) * face.scale)),
+                      juce::jmax(1, juce::roundToInt(static_cast<float>(face.height) * face.scale)),
+                      true);
+
+    {
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(face.scale));
+        render(g, { 0.0f, 0.0f, static_cast<float>(face.width), static_cast<float>(face.height) }, face);
+    }
+
+    return faces.emplace(face, image).first->second;
+}
+
+//==============================================================================
+void KeyFaceCache::render(juce::Graphics& g, juce::Rectangle<float> bounds, const KeyFace& face)
+{
+    // Key body
+    const auto keyColour = face.black ? getBlackKeyColour() : getWhiteKeyColour();
+    g.setColour(keyColour);
+    g.fillRoundedRectangle(bounds, cornerRadius);
+
+    if (face.sounding)
+    {
+        g.setColour(getSoundingTint());
+        g.fillRoundedRectangle(bounds, cornerRadius);
+    }
+
+    // Pressed or hovered section, brightened a little on hover and more while pressed
+    const float sectionHeight = bounds.getHeight() / static_cast<float>(face.numSections);
+
+    if (face.highlightedSection >= 0)
+    {
+        const bool top = face.highlightedSection == 0;
+        const bool bottom = face.highlightedSection == face.numSections - 1;
+
+        juce::Path highlight;
+        highlight.addRoundedRectangle(bounds.getX(), bounds.getY() + sectionHeight * static_cast<float>(face.highlightedSection),
+                                      bounds.getWidth(), sectionHeight, cornerRadius, cornerRadius,
+                                      top, top, bottom, bottom);
+
+        g.setColour(keyColour.brighter(face.pressed ? 0.2f : 0.1f));
+        g.fillPath(highlight);
+    }
+
+    // Border: orange in the scale, grey for black keys outside it, none for white ones
+    if (face.inScale || face.black)
+    {
+        g.setColour(face.inScale ? getInScaleBorderColour() : getBlackKeyDefaultBorderColour());
+        g.drawRoundedRectangle(bounds.reduced(borderThickness / 2.0f), cornerRadius, borderThickness);
+    }
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(fontSize));
+
+    // XL: the note name along the bottom (styles.chordNameText, paddingBottom: 10)
+    if (face.numSections == 1)
+    {
+        g.drawText(face.labels[0], bounds.withTrimmedBottom(textPaddingBottom), juce::Justification::centredBottom, false);
+        return;
+    }
+
+    // XXL/XXXL: a divider under each section but the last, and each section's label
+    for (int section = 0; section < face.numSections; ++section)
+    {
+        const auto sectionBounds = bounds.withY(bounds.getY() + sectionHeight * static_cast<float>(section))
+                                         .withHeight(sectionHeight);
+
+        if (section < face.numSections - 1)
+        {
+            g.setColour(getSectionDividerColour());
+            g.fillRect(sectionBounds.withTop(sectionBounds.getBottom() - 1.0f).withHeight(borderThickness));
+            g.setColour(juce::Colours::white);
+        }
+
+        g.drawText(face.labels[static_cast<size_t>(section)], sectionBounds, juce::Justification::centred, false);
+    }
+}
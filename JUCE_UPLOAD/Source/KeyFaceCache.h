@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <unordered_map>
+#include "ChordCycler.h"
+
+//==============================================================================
+/*
+    Everything that decides how one key looks: colour, scale highlight, which
+    section is hovered or held, the labels, and the size in logical and
+    physical pixels.
+*/
+struct KeyFace
+{
+    int width = 0;
+    int height = 0;
+    float scale = 1.0f;                 // physical pixels per logical pixel
+    bool black = false;
+    bool inScale = false;
+    bool sounding = false;              // lit by what the engine is playing
+    int numSections = 1;                // 1 for XL, 2 for XXL, 3 for XXXL
+    int highlightedSection = -1;        // hovered or pressed section, or -1
+    bool pressed = false;
+
+    // XL keys show labels[0] along the bottom; split keys one label per section
+    std::array<juce::String, ChordCycler::maxSectionsPerKey> labels;
+
+    bool operator==(const KeyFace& other) const;
+};
+
+//==============================================================================
+/*
+    Pre-rendered key images, so that painting a key is a single blit. The
+    rounded body, the highlight, the border and the text layout are drawn once
+    per distinct KeyFace, which is what keeps a fast glissando cheap: hover and
+    press repaints cycle through faces that are already there.
+
+    Images are rendered at the display's physical scale, so blitting them is
+    1:1 on HiDPI screens too. A resize or skin change makes every face stale;
+    clear() drops them all. The cache also clears itself when it reaches
+    maxFaces, which a steady state (12 keys, each idle, hovered or pressed per
+    section) never gets near.
+*/
+class KeyFaceCache
+{
+public:
+    static constexpr size_t maxFaces = 128;
+
+    KeyFaceCache();
+
+    // The image for a face, rendering it on first use
+    const juce::Image& getImage(const KeyFace& face);
+
+    void clear();
+    size_t getNumFaces() const { return faces.size(); }
+
+    // Draws a face straight into a context, as the cache does into its images
+    static void render(juce::Graphics& g, juce::Rectangle<float> bounds, const KeyFace& face);
+
+    static juce::Colour getWhiteKeyColour() { return juce::Colour::fromString("#FF4A4A4A"); }
+    static juce::Colour getBlackKeyColour() { return juce::Colour::fromString("#FF000000"); }
+    static juce::Colour getInScaleBorderColour() { return juce::Colour::fromString("#FFFF9500"); }
+    static juce::Colour getBlackKeyDefaultBorderColour() { return juce::Colour::fromString("#FF4A4A4A"); }
+    static juce::Colour getSoundingTint() { return getInScaleBorderColour().withAlpha(0.35f); }
+    static juce::Colour getSectionDividerColour() { return juce::Colour::fromFloatRGBA(1.0f, 149.0f / 255.0f, 0.0f, 0.4f); }
+
+private:
+    struct FaceHash
+    {
+        size_t operator()(const KeyFace& face) const;
+    };
+
+    std::unordered_map<KeyFace, juce::Image, FaceHash> faces;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyFaceCache)
+};
@@ -0,0 +1,235 @@
+#include "KeyboardComponent.h"
+
+KeyboardComponent::KeyboardComponent()
+{
+    setRepaintsOnMouseActivity(false);  // hover and press repaint just their key
+    pressedSlots.fill(-1);
+}
+
+KeyboardComponent::~KeyboardComponent()
+{
+}
+
+void KeyboardComponent::setKeyBounds(int pitchClass, juce::Rectangle<float> bounds)
+{
+    auto& current = keyBounds[static_cast<size_t>(getPitchClass(pitchClass))];
+
+    if (current != bounds)
+    {
+        // Faces of the old size won't be drawn again
+        if (current.getWidth() != bounds.getWidth() || current.getHeight() != bounds.getHeight())
+            faceCache.clear();
+
+        repaintArea(current);
+        current = bounds;
+        repaintArea(current);
+    }
+}
+
+void KeyboardComponent::setNumSections(int newNumSections)
+{
+    newNumSections = juce::jlimit(1, ChordCycler::maxSectionsPerKey, newNumSections);
+
+    if (numSections != newNumSections)
+    {
+        numSections = newNumSections;
+        hoveredSlot = -1;
+
+        // Held slots no longer exist, so their chords stop too
+        for (int finger = 0; finger < maxFingers; ++finger)
+            releaseFinger(finger);
+
+        RepaintBatcher::repaint(repaintBatcher, *this);
+    }
+}
+
+void KeyboardComponent::setScaleMask(juce::uint16 newScaleMask)
+{
+    const auto changedKeys = static_cast<juce::uint16>(scaleMask ^ newScaleMask);
+    scaleMask = newScaleMask;
+
+    for (int pitchClass = 0; pitchClass < numKeys; ++pitchClass)
+        if (containsPitchClass(changedKeys, pitchClass))
+            repaintArea(keyBounds[static_cast<size_t>(pitchClass)]);
+}
+
+void KeyboardComponent::setSoundingMask(juce::uint16 newSoundingMask)
+{
+    const auto changedKeys = static_cast<juce::uint16>(soundingMask ^ newSoundingMask);
+    soundingMask = newSoundingMask;
+
+    for (int pitchClass = 0; pitchClass < numKeys; ++pitchClass)
+        if (containsPitchClass(changedKeys, pitchClass))
+            repaintArea(keyBounds[static_cast<size_t>(pitchClass)]);
+}
+
+void KeyboardComponent::setSlotLabel(int slot, const juce::String& label)
+{
+    if (slot < 0 || slot >= numSlots)
+        return;
+
+    auto& current = slotLabels[static_cast<size_t>(slot)];
+
+    if (current != label)
+    {
+        current = label;
+
+        if (numSections > 1 && slot % ChordCycler::maxSectionsPerKey < numSections)
+            repaintSlot(slot);
+    }
+}
+
+void KeyboardComponent::clearFaceCache()
+{
+    faceCache.clear();
+    RepaintBatcher::repaint(repaintBatcher, *this);
+}
+
+int KeyboardComponent::getSlotAt(juce::Point<float> position) const
+{
+    for (auto it = paintOrder.rbegin(); it != paintOrder.rend(); ++it)
+    {
+        const auto& bounds = keyBounds[*it];
+
+        if (bounds.contains(position))
+        {
+            const auto section = static_cast<int>((position.y - bounds.getY()) / bounds.getHeight() * static_cast<float>(numSections));
+            return ChordCycler::getSlot(*it, juce::jmin(section, numSections - 1));
+        }
+    }
+
+    return -1;
+}
+
+void KeyboardComponent::repaintArea(juce::Rectangle<float> area)
+{
+    RepaintBatcher::repaint(repaintBatcher, *this, area.getSmallestIntegerContainer());
+}
+
+void KeyboardComponent::repaintSlot(int slot)
+{
+    if (slot >= 0)
+        repaintArea(keyBounds[static_cast<size_t>(slot / ChordCycler::maxSectionsPerKey)]);
+}
+
+void KeyboardComponent::setHoveredSlot(int slot)
+{
+    if (hoveredSlot != slot)
+    {
+        repaintSlot(hoveredSlot);
+        hoveredSlot = slot;
+        repaintSlot(hoveredSlot);
+    }
+}
+
+//==============================================================================
+void KeyboardComponent::paint(juce::Graphics& g)
+{
+    const auto clip = g.getClipBounds().toFloat();
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    for (const auto pitchClass : paintOrder)
+    {
+        const auto& bounds = keyBounds[pitchClass];
+
+        if (bounds.intersects(clip))
+            g.drawImage(faceCache.getImage(getFace(pitchClass, scale)), bounds);
+    }
+}
+
+KeyFace KeyboardComponent::getFace(int pitchClass, float scale) const
+{
+    const auto bounds = keyBounds[static_cast<size_t>(pitchClass)];
+
+    KeyFace face;
+    face.width = juce::roundToInt(bounds.getWidth());
+    face.height = juce::roundToInt(bounds.getHeight());
+    face.scale = scale;
+    face.black = isBlackKey(pitchClass);
+    face.inScale = containsPitchClass(scaleMask, pitchClass);
+    face.sounding = containsPitchClass(soundingMask, pitchClass);
+    face.numSections = numSections;
+
+    // A held section shows over a hovered one
+    for (const auto slot : pressedSlots)
+    {
+        if (slot >= 0 && slot / ChordCycler::maxSectionsPerKey == pitchClass)
+        {
+            face.highlightedSection = slot % ChordCycler::maxSectionsPerKey;
+            face.pressed = true;
+            break;
+        }
+    }
+
+    if (!face.pressed && hoveredSlot >= 0 && hoveredSlot / ChordCycler::maxSectionsPerKey == pitchClass)
+        face.highlightedSection = hoveredSlot % ChordCycler::maxSectionsPerKey;
+
+    if (numSections == 1)
+    {
+        face.labels[0] = pitchClassNames[static_cast<size_t>(pitchClass)];
+        return face;
+    }
+
+    for (int section = 0; section < numSections; ++section)
+        face.labels[static_cast<size_t>(section)] = slotLabels[static_cast<size_t>(ChordCycler::getSlot(pitchClass, section))];
+
+    return face;
+}
+
+bool KeyboardComponent::hitTest(int x, int y)
+{
+    return getSlotAt({ static_cast<float>(x), static_cast<float>(y) }) >= 0;
+}
+
+//==============================================================================
+void KeyboardComponent::mouseMove(const juce::MouseEvent& event)
+{
+    setHoveredSlot(getSlotAt(event.position));
+}
+
+void KeyboardComponent::mouseExit(const juce::MouseEvent&)
+{
+    setHoveredSlot(-1);
+}
+
+void KeyboardComponent::mouseDown(const juce::MouseEvent& event)
+{
+    const int finger = event.source.getIndex();
+    const int slot = getSlotAt(event.position);
+    if (slot < 0 || !juce::isPositiveAndBelow(finger, maxFingers))
+        return;
+
+    // A pointer only ever holds one slot
+    releaseFinger(finger);
+
+    pressedSlots[static_cast<size_t>(finger)] = slot;
+    repaintSlot(slot);
+
+    // Keys sound on press, like onPressIn in PianoXL.tsx, not on release as a Button would
+    if (onSlotPressed)
+        onSlotPressed(slot / ChordCycler::maxSectionsPerKey, slot % ChordCycler::maxSectionsPerKey, finger);
+}
+
+void KeyboardComponent::mouseUp(const juce::MouseEvent& event)
+{
+    releaseFinger(event.source.getIndex());
+
+    if (event.source.isMouse())
+        setHoveredSlot(getSlotAt(event.position));
+}
+
+void KeyboardComponent::releaseFinger(int finger)
+{
+    if (!juce::isPositiveAndBelow(finger, maxFingers))
+        return;
+
+    const int slot = pressedSlots[static_cast<size_t>(finger)];
+    if (slot < 0)
+        return;
+
+    pressedSlots[static_cast<size_t>(finger)] = -1;
+    repaintSlot(slot);
+
+    if (onSlotReleased)
+        onSlotReleased(slot / ChordCycler::maxSectionsPerKey, slot % ChordCycler::maxSectionsPerKey, finger);
+}
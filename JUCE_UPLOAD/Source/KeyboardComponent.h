@@ -0,0 +1,111 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <functional>
+#include "ChordCycler.h"
+#include "KeyFaceCache.h"
+#include "RepaintBatcher.h"
+
+//==============================================================================
+/*
+    The whole one-octave keyboard as a single component, replacing one
+    PianoKeyComponent (a full juce::Button) per key.
+
+    PianoXL.tsx splits each key into two (XXL) or three (XXXL) stacked
+    Pressables, which would have meant up to 36 child components. Here every
+    key and slot is an entry in flat arrays indexed by pitch class, or by
+    ChordCycler slot:
+      - paint() draws the white keys, then the black keys over them, in one
+        pass, skipping any key outside the clip region
+      - mouse events are hit-tested against the same rectangles, black keys
+        first since they sit on top
+      - a state change repaints only the rectangle of the key it touches,
+        through the window's RepaintBatcher when it has one
+      - each key is one blit of a KeyFaceCache image
+      - keys sound on mouse-down and stop on mouse-up; every pointer (mouse
+        or touch, by MouseInputSource index) holds its own slot, so several
+        fingers can hold several keys at once
+    Points between keys aren't hits (hitTest()), so clicks there reach
+    whatever is behind the keyboard.
+*/
+class KeyboardComponent : public juce::Component
+{
+public:
+    static constexpr int numKeys = 12;
+    static constexpr int numSlots = ChordCycler::numSlots;
+    static constexpr int maxFingers = 10;       // pointers beyond this are ignored
+
+    KeyboardComponent();
+    ~KeyboardComponent() override;
+
+    // Key rectangles in this component's coordinates, set by the parent's layout
+    void setKeyBounds(int pitchClass, juce::Rectangle<float> bounds);
+    juce::Rectangle<float> getKeyBounds(int pitchClass) const { return keyBounds[static_cast<size_t>(pitchClass)]; }
+
+    // Collects this keyboard's repaints with the rest of the window's; null repaints directly
+    void setRepaintBatcher(RepaintBatcher* newBatcher) { repaintBatcher = newBatcher; }
+
+    // 1 for XL, 2 for XXL, 3 for XXXL
+    void setNumSections(int newNumSections);
+    int getNumSections() const { return numSections; }
+
+    // Highlights the keys in the mask, repainting only those that change
+    void setScaleMask(juce::uint16 newScaleMask);
+
+    // Lights the keys whose notes the engine is playing, repainting only those that change
+    void setSoundingMask(juce::uint16 newSoundingMask);
+
+    // Text on a split key's section; XL keys always show their note name
+    void setSlotLabel(int slot, const juce::String& label);
+
+    // Called with the pitch class and section under a pointer, and the pointer's index
+    std::function<void(int pitchClass, int section, int finger)> onSlotPressed;
+    std::function<void(int pitchClass, int section, int finger)> onSlotReleased;
+
+    // Drops every pre-rendered key; for a change of look such as a new skin
+    void clearFaceCache();
+
+    // Slot at a point in this component, or -1 between keys
+    int getSlotAt(juce::Point<float> position) const;
+
+    static bool isBlackKey(int pitchClass)
+    {
+        return ((1 << getPitchClass(pitchClass)) & blackKeyMask) != 0;
+    }
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    bool hitTest(int x, int y) override;
+
+    void mouseMove(const juce::MouseEvent& event) override;
+    void mouseExit(const juce::MouseEvent& event) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseUp(const juce::MouseEvent& event) override;
+
+private:
+    static constexpr juce::uint16 blackKeyMask = 0b010101001010;   // C#, D#, F#, G#, A#
+
+    // White keys first so the black keys paint over them; hit-testing walks it backwards
+    static constexpr std::array<juce::uint8, numKeys> paintOrder { 0, 2, 4, 5, 7, 9, 11, 1, 3, 6, 8, 10 };
+
+    KeyFace getFace(int pitchClass, float scale) const;
+    void repaintArea(juce::Rectangle<float> area);
+    void repaintSlot(int slot);
+    void setHoveredSlot(int slot);
+    void releaseFinger(int finger);
+
+    std::array<juce::Rectangle<float>, numKeys> keyBounds {};
+    std::array<juce::String, numSlots> slotLabels;
+
+    int numSections = 1;
+    juce::uint16 scaleMask = 0;
+    juce::uint16 soundingMask = 0;
+    int hoveredSlot = -1;
+    std::array<int, maxFingers> pressedSlots;   // slot each pointer holds, or -1
+
+    KeyFaceCache faceCache;
+    RepaintBatcher* repaintBatcher = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyboardComponent)
+};
@@ -1,4 +1,5 @@
 #include "MainComponent.h"
+#include "RealtimeSafetyChecker.h"
 #include <iostream> // For std::cout
 
 MainComponent::MainComponent()
@@ -10,33 +11,34 @@ MainComponent::MainComponent()
     // Set an initial size for the component itself.
     setSize (static_cast<int>(baseWidth), static_cast<int>(baseHeight));
 
-    // Initialize White Keys
-    for (int i = 0; i < 7; ++i)
-    {
-        // Default to "C" key in scale for now for visual testing, others not in scale
-        bool isInScale = (whiteKeyNotes[i] == "C" || whiteKeyNotes[i] == "E" || whiteKeyNotes[i] == "G"); 
-        whiteKeys.push_back(std::make_unique<PianoKeyComponent>(whiteKeyNotes[i], false, isInScale));
-        addAndMakeVisible(*whiteKeys.back());
-    }
-
-    // Initialize Black Keys
-    // Black keys should be added after white keys so they are drawn on top by default.
-    for (int i = 0; i < 6; ++i) // 6 potential positions in blackKeyNotes array
-    {
-        if (!blackKeyNotes[i].isEmpty()) // Skip placeholders
-        {
-            // Default to "F#" key in scale for now
-            bool isInScale = (blackKeyNotes[i] == "F#");
-            blackKeys.push_back(std::make_unique<PianoKeyComponent>(blackKeyNotes[i], true, isInScale));
-            addAndMakeVisible(*blackKeys.back());
-        }
-    }
+    // Piano keys. Highlights start from scaleMask and follow setScale().
+    keyboard.setRepaintBatcher(&repaintBatcher);
+    keyboard.setScaleMask(scaleMask);
+    addAndMakeVisible(keyboard);
     
     // Initialize and make visible the title component, fader, and settings panel
     addAndMakeVisible(titleComponent);
     addAndMakeVisible(verticalFader);
     addAndMakeVisible(settingsPanel);
     settingsPanel.addListener(this); // Add this component as a listener
+    settingsPanel.setRepaintBatcher(&repaintBatcher);
+
+    // Keys follow what the engine plays, whatever started it
+    repaintBatcher.onVBlank = [this]
+    {
+        showEngineState();
+        logLatencyMeasurements();
+    };
+
+   #if PIANOXL_MEASURE_LATENCY
+    // Logs how long each press from silence takes to reach the speakers
+    audioEngine.setLatencyProbeEnabled(true);
+   #endif
+
+    // Space plays/stops the progression, left/right pick an imported song, A and L play
+    // and loop the library as a song, F12 logs what the interactions so far cost to
+    // redraw (see keyPressed)
+    setWantsKeyboardFocus(true);
 
     // Plus/Minus Buttons
     plusButton.setButtonText("+");
@@ -57,42 +59,73 @@ MainComponent::MainComponent()
     buttonStyle(minusButton);
 
     plusButton.onClick = [this] {
+        if (settingsPanel.getSelectedControl() == "key")
+        {
+            setScale(currentKey + 1, currentMode);
+            return;
+        }
+
+        if (settingsPanel.getSelectedControl() == "chord")
+        {
+            cycleLastChordType(1);
+            return;
+        }
+
+        if (settingsPanel.getSelectedControl() == "sustain")
+        {
+            setSustain((int) state.getProperty("sustain", 100) + 10);
+            return;
+        }
+
         int value = (int) state.getProperty("inversion", 0);
         value += 1;
         if (value > 5) value = 5;
         state.setProperty("inversion", value, nullptr);
         settingsPanel.setInversionValue(value);
+        voicingEngine.setInversion(value);
         std::cout << "Plus button clicked, inversion=" << value << std::endl;
     };
     minusButton.onClick = [this] {
+        if (settingsPanel.getSelectedControl() == "key")
+        {
+            setScale(currentKey - 1, currentMode);
+            return;
+        }
+
+        if (settingsPanel.getSelectedControl() == "chord")
+        {
+            cycleLastChordType(-1);
+            return;
+        }
+
+        if (settingsPanel.getSelectedControl() == "sustain")
+        {
+            setSustain((int) state.getProperty("sustain", 100) - 10);
+            return;
+        }
+
         int value = (int) state.getProperty("inversion", 0);
         value -= 1;
         if (value < -5) value = -5;
         state.setProperty("inversion", value, nullptr);
         settingsPanel.setInversionValue(value);
+        voicingEngine.setInversion(value);
         std::cout << "Minus button clicked, inversion=" << value << std::endl;
     };
 
     addAndMakeVisible(plusButton);
     addAndMakeVisible(minusButton);
 
-    // Add basic interactions (lambdas for simplicity)
-    for (auto& key : whiteKeys)
-    {
-        key->onClick = [name = key->getButtonText()] {
-            std::cout << "White key " << name << " clicked." << std::endl;
-        };
-    }
-
-    for (auto& key : blackKeys)
-    {
-        key->onClick = [name = key->getButtonText()] {
-            std::cout << "Black key " << name << " clicked." << std::endl;
-        };
-    }
+    // Each key section plays its chord on the key's note plus the matching bass note (handleKeyPress)
+    // while its finger is down; each finger holds its own chord (see AudioEngine::fingerDownFromUI)
+    keyboard.onSlotPressed = [this] (int pitchClass, int section, int finger) { playKey(pitchClass, section, finger); };
+    keyboard.onSlotReleased = [this] (int, int, int finger) { audioEngine.fingerUpFromUI(finger); };
 
+    // The fader balances chord against bass, as in PianoXL.tsx's handleKeyPress
     verticalFader.onValueChange = [this] {
-        std::cout << "Fader value: " << verticalFader.getValue() << std::endl;
+        const auto value = static_cast<float>(verticalFader.getValue());
+        audioEngine.setParameterFromUI(EngineParameter::chordVolume, value);
+        audioEngine.setParameterFromUI(EngineParameter::bassVolume, 1.0f - value);
     };
 
     titleComponent.getXlButton().onClick = [this] {
@@ -100,6 +133,9 @@ MainComponent::MainComponent()
         if (currentText == "XL") titleComponent.getXlButton().setButtonText("XXL");
         else if (currentText == "XXL") titleComponent.getXlButton().setButtonText("XXXL");
         else titleComponent.getXlButton().setButtonText("XL");
+
+        // XL, XXL and XXXL split each key into one, two or three sections
+        keyboard.setNumSections(titleComponent.getXlButton().getButtonText().length() - 1);
         std::cout << "XL Button clicked. New mode: " << titleComponent.getXlButton().getButtonText() << std::endl;
     };
 
@@ -110,11 +146,355 @@ MainComponent::MainComponent()
     bool invSel = state.getProperty("inversionSelected", false);
     settingsPanel.setInversionValue(invVal);
     inversionSelectionChanged(invSel, invVal);
+    settingsPanel.setVoiceLeading(state.getProperty("voiceLeading", false));
+    voiceLeadingChanged(state.getProperty("voiceLeading", false));
+
+    const int instrumentIndex = juce::jlimit(0, numInstruments - 1, (int) state.getProperty("instrument", 0));
+    settingsPanel.setInstrument(static_cast<InstrumentType>(instrumentIndex));
+    instrumentChanged(static_cast<InstrumentType>(instrumentIndex));
+    settingsPanel.setRecordAudio(state.getProperty("recordAudio", true));
+
+    const int flamIndex = juce::jlimit(0, static_cast<int>(FlamValue::sixteenth), (int) state.getProperty("flam", 0));
+    settingsPanel.setFlam(static_cast<FlamValue>(flamIndex));
+    flamChanged(static_cast<FlamValue>(flamIndex));
+
+    setSustain(state.getProperty("sustain", 100));
+    const auto releaseModel = (int) state.getProperty("releaseModel", 0) != 0 ? EnvelopeBank::ReleaseModel::timed
+                                                                               : EnvelopeBank::ReleaseModel::noteOff;
+    settingsPanel.setReleaseModel(releaseModel);
+    releaseModelChanged(releaseModel);
+
+    // Read before setScale, which clears them when the key or mode changes
+    const auto savedBassOffsets = state.getProperty("bassOffsets").toString();
+
+    const int modeIndex = juce::jlimit(0, numModes - 1, (int) state.getProperty("mode", 0));
+    setScale((int) state.getProperty("key", 0), static_cast<MusicMode>(modeIndex));
+    loadBassOffsets(savedBassOffsets);
+
+    // Stereo output only, no inputs
+    setAudioChannels(0, 2);
 
     // Force an initial layout
     resized();
 }
 
+int MainComponent::getMidiNoteForKey(int pitchClass)
+{
+    return 60 + getPitchClass(pitchClass); // MIDDLE_C from chord-utils.ts
+}
+
+int MainComponent::getBassNoteForKey(int pitchClass, int bassOffset)
+{
+    // Bass note from handleKeyPress in PianoXL.tsx: C3 upwards, folded down an octave
+    // from F so the bass stays low. bassOffset is the key slot's bass-offset-config.ts
+    // value (+-2, +-3), or 0 for the root.
+    const int bassIndex = getPitchClass(pitchClass + bassOffset);
+    return 48 + bassIndex + (bassIndex >= 5 ? -12 : 0);
+}
+
+void MainComponent::playKey(int pitchClass, int section, int finger)
+{
+    // Keys outside the scale are silent, as in handleKeyPress
+    if (!containsPitchClass(scaleMask, pitchClass))
+        return;
+
+    const int rootNote = getMidiNoteForKey(pitchClass);
+    lastPlayedSlot = ChordCycler::getSlot(pitchClass, section);
+
+    const auto chord = voicingEngine.voice(rootNote, chordCycler.getChordType(lastPlayedSlot));
+    const int bassNote = getBassNoteForKey(pitchClass, bassOffsets[static_cast<size_t>(lastPlayedSlot)]);
+
+    audioEngine.fingerDownFromUI(finger, chord, bassNote);
+
+    // The bass is always the lowest note, so it picks between readings such as C6 and Am7
+    auto heldPitchClasses = static_cast<juce::uint16>(1 << getPitchClass(bassNote));
+    for (auto note : chord)
+        heldPitchClasses = static_cast<juce::uint16>(heldPitchClasses | (1 << getPitchClass(note)));
+
+    // Named straight away; the suggestions follow once the chord is heard (showEngineState)
+    const auto recognized = chordRecognizer.recognize(heldPitchClasses, getPitchClass(bassNote));
+    settingsPanel.setChordName(ChordRecognizer::getChordName(recognized));
+
+    // The bass clef button shows and edits the offset of the slot just played
+    settingsPanel.setBassOffset(bassOffsets[static_cast<size_t>(lastPlayedSlot)]);
+}
+
+void MainComponent::showSuggestions()
+{
+    juce::String suggestionNames;
+
+    if (lastHeardChord.isValid())
+    {
+        for (const auto& suggestion : suggestionEngine.getSuggestions(lastHeardChord, currentKey, currentMode, 3))
+        {
+            RecognizedChord suggested;
+            suggested.root = suggestion.root;
+            suggested.type = suggestion.type;
+            suggested.bass = suggestion.root;
+            suggestionNames << ChordRecognizer::getChordName(suggested) << " ";
+        }
+    }
+
+    settingsPanel.setSuggestions(suggestionNames.trimEnd());
+}
+
+void MainComponent::showEngineState()
+{
+    EngineStateSnapshot snapshot;
+    if (audioEngine.readStateSnapshot(snapshot))
+        engineStateDelay.push(snapshot);
+
+    if (!engineStateDelay.update(juce::Time::getMillisecondCounterHiRes(), getOutputLatencyMs()))
+        return;
+
+    const auto& heard = engineStateDelay.getCurrent();
+    const auto soundingPitchClasses = heard.getSoundingPitchClasses();
+    keyboard.setSoundingMask(soundingPitchClasses);
+
+    // Progression steps and MIDI input get a chord name too; silence keeps the last one
+    if (!heard.hasNotes())
+        return;
+
+    const int bassNote = heard.bassNote >= 0 ? heard.bassNote : heard.getLowestNote();
+    auto heldPitchClasses = soundingPitchClasses;
+    if (bassNote >= 0)
+        heldPitchClasses = static_cast<juce::uint16>(heldPitchClasses | (1 << getPitchClass(bassNote)));
+
+    const auto recognized = chordRecognizer.recognize(heldPitchClasses, bassNote >= 0 ? getPitchClass(bassNote) : -1);
+    if (!recognized.isValid() || recognized == lastHeardChord)
+        return;
+
+    lastHeardChord = recognized;
+    settingsPanel.setChordName(ChordRecognizer::getChordName(recognized));
+    showSuggestions();
+}
+
+bool MainComponent::keyPressed(const juce::KeyPress& key)
+{
+    // Space starts and stops the loaded progression (playProgression in audio-utils.ts),
+    // or stops the song when that's playing
+    if (key == juce::KeyPress(juce::KeyPress::spaceKey))
+    {
+        if (arrangementPlaying)
+            setArrangementPlaying(false);
+        else
+            setProgressionPlaying(!progressionPlaying);
+
+        return true;
+    }
+
+    // A plays the library as one song from the current song's section; L loops that section
+    if (key.getTextCharacter() == 'a' || key.getTextCharacter() == 'A')
+    {
+        setArrangementPlaying(true);
+        return true;
+    }
+
+    if (key.getTextCharacter() == 'l' || key.getTextCharacter() == 'L')
+    {
+        setSectionLooping(!sectionLooping);
+        return true;
+    }
+
+    // Left/right step through the imported songs
+    if (key == juce::KeyPress(juce::KeyPress::leftKey) || key == juce::KeyPress(juce::KeyPress::rightKey))
+    {
+        loadLibraryProgression(currentProgression + (key.getKeyCode() == juce::KeyPress::rightKey ? 1 : -1));
+        return true;
+    }
+
+    if (key != juce::KeyPress(juce::KeyPress::F12Key))
+        return false;
+
+    // Repaint cost since the last report, then start counting afresh
+    const auto& stats = repaintBatcher.getStats();
+    const auto flushes = juce::jmax<juce::int64>(1, stats.numFlushes);
+
+    std::cout << "Repaints: " << stats.numFlushes << " flushes, " << stats.numRequests << " requests, "
+              << stats.numRectangles << " rects, " << stats.numPixels / flushes << " px per flush on average, "
+              << stats.maxPixels << " px at most" << std::endl;
+
+    repaintBatcher.resetStats();
+    return true;
+}
+
+void MainComponent::setProgressionPlaying(bool shouldPlay)
+{
+    // The progression and the song would fight over the voices
+    if (shouldPlay && arrangementPlaying)
+        setArrangementPlaying(false);
+
+    if (!(shouldPlay ? audioEngine.startProgressionFromUI() : audioEngine.stopProgressionFromUI()))
+        return;
+
+    progressionPlaying = shouldPlay;
+    std::cout << "Progression " << (progressionPlaying ? "playing" : "stopped") << std::endl;
+}
+
+void MainComponent::setArrangementPlaying(bool shouldPlay)
+{
+    if (shouldPlay)
+    {
+        if (!juce::isPositiveAndBelow(currentProgression, static_cast<int>(sectionFirstBars.size()) - 1))
+            return;
+
+        setProgressionPlaying(false);
+    }
+
+    const int fromBar = shouldPlay ? sectionFirstBars[static_cast<size_t>(currentProgression)] : 0;
+    if (!(shouldPlay ? audioEngine.playArrangementFromUI(fromBar) : audioEngine.stopArrangementFromUI()))
+        return;
+
+    arrangementPlaying = shouldPlay;
+
+    if (arrangementPlaying)
+        std::cout << "Song playing from bar " << fromBar + 1 << " of " << sectionFirstBars.back() << std::endl;
+    else
+        std::cout << "Song stopped" << std::endl;
+}
+
+void MainComponent::setSectionLooping(bool shouldLoop)
+{
+    if (shouldLoop && !juce::isPositiveAndBelow(currentProgression, static_cast<int>(sectionFirstBars.size()) - 1))
+        return;
+
+    // An empty range turns looping off
+    const int startBar = shouldLoop ? sectionFirstBars[static_cast<size_t>(currentProgression)] : 0;
+    const int endBar = shouldLoop ? sectionFirstBars[static_cast<size_t>(currentProgression) + 1] : 0;
+
+    if (!audioEngine.setArrangementLoopFromUI(startBar, endBar))
+        return;
+
+    sectionLooping = shouldLoop;
+    std::cout << "Section loop: " << (sectionLooping ? "bars " + juce::String(startBar + 1) + "-" + juce::String(endBar)
+                                                    : juce::String("off")) << std::endl;
+}
+
+void MainComponent::arrangeLibrary()
+{
+    std::vector<ArrangementSection> sections;
+    sections.reserve(progressionLibrary.size());
+    sectionFirstBars.clear();
+
+    int bar = 0;
+
+    for (const auto& song : progressionLibrary)
+    {
+        ArrangementSection section;
+        section.name = song.file.getFileNameWithoutExtension();
+        section.bpm = song.progression.bpm;
+        section.beatsPerBar = song.progression.beatsPerBar;
+        section.beatUnit = song.progression.beatUnit;
+
+        double beats = 0.0;
+        for (const auto& chord : song.progression.chords)
+        {
+            section.steps.push_back({ chord.notes, chord.beats });
+            beats += chord.beats;
+        }
+
+        // Whole bars, set here so each song's first bar is known for seeking and looping
+        section.bars = juce::jmax(1, static_cast<int>(std::ceil(beats / juce::jlimit(1, 32, section.beatsPerBar))));
+
+        sectionFirstBars.push_back(bar);
+        bar += section.bars;
+        sections.push_back(std::move(section));
+    }
+
+    sectionFirstBars.push_back(bar);
+
+    // Loading a song stops the one playing and clears its loop
+    audioEngine.loadArrangementFromUI(sections);
+    arrangementPlaying = false;
+    sectionLooping = false;
+}
+
+void MainComponent::logLatencyMeasurements()
+{
+    AudioEngine::LatencyMeasurement measurement;
+    while (audioEngine.popLatencyMeasurement(measurement))
+    {
+        const double deviceMs = getOutputLatencyMs();
+        const double totalMs = measurement.inputToBlockMs + measurement.offsetInBlockMs + deviceMs;
+
+        std::cout << "Key latency: " << juce::String(totalMs, 1) << " ms (queue "
+                  << juce::String(measurement.inputToBlockMs, 1) << " + in block "
+                  << juce::String(measurement.offsetInBlockMs, 1) << " + device "
+                  << juce::String(deviceMs, 1) << ")" << std::endl;
+    }
+}
+
+double MainComponent::getOutputLatencyMs()
+{
+    // A block starts reaching the speakers a buffer plus the device's output latency after it begins
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        const double sampleRate = device->getCurrentSampleRate();
+        if (sampleRate > 0.0)
+            return (device->getOutputLatencyInSamples() + device->getCurrentBufferSizeSamples()) * 1000.0 / sampleRate;
+    }
+
+    return 0.0;
+}
+
+void MainComponent::cycleLastChordType(int direction)
+{
+    if (lastPlayedSlot < 0)
+        return;
+
+    chordCycler.cycle(lastPlayedSlot, direction);
+    updateSlotLabel(lastPlayedSlot);
+
+    // Show what the key will play next, as a chord on the key without a bass note
+    RecognizedChord next;
+    next.root = lastPlayedSlot / ChordCycler::maxSectionsPerKey;
+    next.type = chordCycler.getChordType(lastPlayedSlot);
+    next.bass = next.root;
+    settingsPanel.setChordName(ChordRecognizer::getChordName(next));
+}
+
+void MainComponent::updateSlotLabel(int slot)
+{
+    RecognizedChord chord;
+    chord.root = slot / ChordCycler::maxSectionsPerKey;
+    chord.type = chordCycler.getChordType(slot);
+    chord.bass = getPitchClass(chord.root + bassOffsets[static_cast<size_t>(slot)]);    // slash chord when offset
+    keyboard.setSlotLabel(slot, ChordRecognizer::getChordName(chord));
+}
+
+void MainComponent::updateSlotLabels()
+{
+    for (int slot = 0; slot < ChordCycler::numSlots; ++slot)
+        updateSlotLabel(slot);
+}
+
+void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // setAudioChannels asks for stereo, but a mono output device only opens one channel
+    int numOutputChannels = 2;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        numOutputChannels = device->getActiveOutputChannels().countNumberOfSetBits();
+
+    audioEngine.prepareToPlay(samplesPerBlockExpected, sampleRate, numOutputChannels);
+}
+
+void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+
+    // Refer to the region we've been asked to fill without copying or allocating
+    juce::AudioBuffer<float> region(bufferToFill.buffer->getArrayOfWritePointers(),
+                                    bufferToFill.buffer->getNumChannels(),
+                                    bufferToFill.startSample,
+                                    bufferToFill.numSamples);
+    audioEngine.renderNextBlock(region);
+}
+
+void MainComponent::releaseResources()
+{
+    audioEngine.releaseResources();
+}
+
 void MainComponent::inversionSelectionChanged(bool isSelected, int value)
 {
     // Enable/disable plus/minus buttons based on selection state
@@ -123,14 +503,303 @@ void MainComponent::inversionSelectionChanged(bool isSelected, int value)
 
     state.setProperty("inversionSelected", isSelected, nullptr);
     state.setProperty("inversion", value, nullptr);
+    voicingEngine.setInversion(value);
 
     std::cout << "Inversion selection changed - Selected: " << (isSelected ? "yes" : "no")
               << ", Value: " << value << std::endl;
 }
 
+void MainComponent::voiceLeadingChanged(bool shouldLeadVoices)
+{
+    state.setProperty("voiceLeading", shouldLeadVoices, nullptr);
+    voicingEngine.setVoiceLeading(shouldLeadVoices);
+    std::cout << "Voice leading: " << (shouldLeadVoices ? "on" : "off") << std::endl;
+}
+
+void MainComponent::instrumentChanged(InstrumentType instrument)
+{
+    state.setProperty("instrument", static_cast<int>(instrument), nullptr);
+    audioEngine.setParameterFromUI(EngineParameter::instrument, static_cast<float>(instrument));
+
+    std::cout << "Instrument changed: " << getInstrument(instrument).label << std::endl;
+}
+
+void MainComponent::selectedControlChanged(const juce::String& control)
+{
+    // Plus/minus step the inversion, the key (a semitone), the last key's chord type or
+    // the sustain (10%)
+    const bool adjustable = control == "inversion" || control == "key" || control == "chord" || control == "sustain";
+    plusButton.setEnabled(adjustable);
+    minusButton.setEnabled(adjustable);
+}
+
+void MainComponent::modeChanged(MusicMode mode)
+{
+    setScale(currentKey, mode);
+}
+
+void MainComponent::recordButtonClicked()
+{
+    if (audioEngine.isRecording())
+    {
+        audioEngine.stopRecordingFromUI();
+        const auto summary = audioEngine.getRecorder().getSummary();
+        settingsPanel.setRecording(false);
+
+        std::cout << "Recording stopped: " << juce::String(summary.seconds, 1) << " s, "
+                  << summary.numNotes << " notes, " << summary.numDroppedEvents << " dropped" << std::endl;
+
+        // Long takes take a while to bounce, so the MIDI file is written in the background
+        audioEngine.getRecorder().bounceToMidiAsync([] (const juce::File& midiFile)
+        {
+            std::cout << "MIDI bounce: " << (midiFile == juce::File() ? juce::String("failed") : midiFile.getFullPathName()) << std::endl;
+        });
+        return;
+    }
+
+    // Each take gets its own folder: events, summary, MIDI bounce and audio
+    const auto takeDirectory = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                   .getChildFile("PianoXL Recordings")
+                                   .getChildFile(juce::Time::getCurrentTime().formatted("Take %Y-%m-%d %H-%M-%S"));
+
+    const int instrumentIndex = juce::jlimit(0, numInstruments - 1, (int) state.getProperty("instrument", 0));
+    const bool withAudio = settingsPanel.getRecordAudio();
+
+    if (audioEngine.startRecordingFromUI(takeDirectory, static_cast<InstrumentType>(instrumentIndex), withAudio))
+    {
+        settingsPanel.setRecording(true);
+        std::cout << "Recording to " << takeDirectory.getFullPathName() << std::endl;
+    }
+}
+
+void MainComponent::memoryButtonClicked()
+{
+    if (progressionLibrary.empty())
+    {
+        std::cout << "MIDI export: the progression library is empty; drop a folder of MIDI files first" << std::endl;
+        return;
+    }
+
+    // The library goes out as one .mid per song, written on the import thread
+    const auto exportDirectory = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                     .getChildFile("PianoXL Progressions")
+                                     .getChildFile(juce::Time::getCurrentTime().formatted("Export %Y-%m-%d %H-%M-%S"));
+
+    std::vector<MidiExportProgression> progressions;
+    progressions.reserve(progressionLibrary.size());
+    for (const auto& song : progressionLibrary)
+        progressions.push_back(song.progression);
+
+    importPool.addJob([progressions = std::move(progressions), exportDirectory]
+    {
+        MidiFileWriter writer;
+        const int numWritten = writer.exportAll(progressions, exportDirectory);
+
+        std::cout << "MIDI export: " << numWritten << " of " << progressions.size() << " progressions to "
+                  << exportDirectory.getFullPathName() << std::endl;
+    });
+}
+
+void MainComponent::recordAudioChanged(bool shouldRecordAudio)
+{
+    state.setProperty("recordAudio", shouldRecordAudio, nullptr);
+    std::cout << "Record audio: " << (shouldRecordAudio ? "on" : "off") << std::endl;
+}
+
+void MainComponent::bassOffsetChanged(int semitones)
+{
+    // As handleBassOffsetChange, the offset belongs to the active slot: the last one played
+    if (lastPlayedSlot < 0)
+    {
+        settingsPanel.setBassOffset(0);
+        std::cout << "Bass offset: play a key first to pick the slot it applies to" << std::endl;
+        return;
+    }
+
+    bassOffsets[static_cast<size_t>(lastPlayedSlot)] = semitones;
+    updateSlotLabel(lastPlayedSlot);
+    saveBassOffsets();
+
+    std::cout << "Bass offset for slot " << lastPlayedSlot << ": " << semitones << std::endl;
+}
+
+void MainComponent::clearBassOffsets()
+{
+    bassOffsets.fill(0);
+    settingsPanel.setBassOffset(0);
+    saveBassOffsets();
+}
+
+void MainComponent::saveBassOffsets()
+{
+    // One number per slot, space separated
+    juce::StringArray offsets;
+    for (auto offset : bassOffsets)
+        offsets.add(juce::String(offset));
+
+    state.setProperty("bassOffsets", offsets.joinIntoString(" "), nullptr);
+}
+
+void MainComponent::loadBassOffsets(const juce::String& savedOffsets)
+{
+    const auto offsets = juce::StringArray::fromTokens(savedOffsets, false);
+
+    for (size_t slot = 0; slot < bassOffsets.size(); ++slot)
+        bassOffsets[slot] = static_cast<int>(slot) < offsets.size() ? juce::jlimit(-11, 11, offsets[static_cast<int>(slot)].getIntValue()) : 0;
+
+    updateSlotLabels();
+    saveBassOffsets();
+}
+
+void MainComponent::flamChanged(FlamValue flam)
+{
+    state.setProperty("flam", static_cast<int>(flam), nullptr);
+    audioEngine.setParameterFromUI(EngineParameter::flam, static_cast<float>(flam));
+    std::cout << "Flam: " << getFlamName(flam) << std::endl;
+}
+
+void MainComponent::releaseModelChanged(EnvelopeBank::ReleaseModel model)
+{
+    const bool timed = model == EnvelopeBank::ReleaseModel::timed;
+    state.setProperty("releaseModel", timed ? 1 : 0, nullptr);
+    audioEngine.setParameterFromUI(EngineParameter::releaseModel, timed ? 1.0f : 0.0f);
+    std::cout << "Release: " << (timed ? "timed" : "note-off") << std::endl;
+}
+
+void MainComponent::setSustain(int percent)
+{
+    // setSustain in audio-utils.ts keeps it within 10-200%
+    percent = juce::jlimit(10, 200, percent);
+    state.setProperty("sustain", percent, nullptr);
+    settingsPanel.setSustain(percent);
+    audioEngine.setParameterFromUI(EngineParameter::sustain, static_cast<float>(percent));
+    std::cout << "Sustain: " << percent << "%" << std::endl;
+}
+
+bool MainComponent::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    for (const auto& path : files)
+        if (juce::File(path).isDirectory())
+            return true;
+
+    return false;
+}
+
+void MainComponent::filesDropped(const juce::StringArray& files, int, int)
+{
+    for (const auto& path : files)
+        if (juce::File(path).isDirectory())
+            importMidiFolder(juce::File(path));
+}
+
+void MainComponent::importMidiFolder(const juce::File& directory)
+{
+    std::cout << "Importing MIDI files from " << directory.getFullPathName() << std::endl;
+
+    // importDirectory blocks while its own workers parse, so it gets a thread of its own
+    importPool.addJob([safeThis = juce::Component::SafePointer<MainComponent>(this), directory]
+    {
+        MidiFileImporter importer;
+        auto results = std::make_shared<std::vector<MidiFileImporter::Result>>();
+        const auto stats = importer.importDirectory(directory, *results);
+
+        juce::MessageManager::callAsync([safeThis, results, stats]
+        {
+            if (safeThis != nullptr)
+                safeThis->midiFolderImported(stats, std::move(*results));
+        });
+    });
+}
+
+void MainComponent::midiFolderImported(const MidiFileImporter::Stats& stats,
+                                       std::vector<MidiFileImporter::Result> results)
+{
+    std::cout << "MIDI import: " << stats.numImported << " of " << stats.numFiles << " files, "
+              << stats.numChords << " chords in " << juce::String(stats.seconds, 2) << " s ("
+              << juce::String(stats.getFilesPerSecond(), 1) << " files/s)" << std::endl;
+
+    // Every song with chords joins the library; the first new one starts playing
+    const int firstNew = static_cast<int>(progressionLibrary.size());
+
+    for (auto& result : results)
+        if (result.imported && !result.progression.chords.empty())
+            progressionLibrary.push_back(std::move(result));
+
+    if (static_cast<int>(progressionLibrary.size()) == firstNew)
+        return;
+
+    std::cout << "Progression library: " << progressionLibrary.size() << " songs" << std::endl;
+    arrangeLibrary();
+    loadLibraryProgression(firstNew);
+    setProgressionPlaying(true);
+}
+
+void MainComponent::loadLibraryProgression(int index)
+{
+    if (progressionLibrary.empty())
+        return;
+
+    const int numSongs = static_cast<int>(progressionLibrary.size());
+    currentProgression = ((index % numSongs) + numSongs) % numSongs;
+    const auto& song = progressionLibrary[static_cast<size_t>(currentProgression)];
+
+    // The sequencer's chords are swapped while it's stopped, then it picks up again
+    const bool wasPlaying = progressionPlaying;
+    setProgressionPlaying(false);
+    audioEngine.loadProgressionFromUI(song.progression);
+
+    juce::String chordNames;
+    for (const auto& chord : song.chordNames)
+        chordNames << ChordRecognizer::getChordName(chord) << " ";
+
+    std::cout << "Loaded " << currentProgression + 1 << "/" << numSongs << " " << song.file.getFileName()
+              << ": " << chordNames.trimEnd() << std::endl;
+
+    if (wasPlaying)
+        setProgressionPlaying(true);
+}
+
+void MainComponent::setScale(int keyPitchClass, MusicMode mode)
+{
+    // Bass offsets are cleared on every mode change, and on key changes outside FREE,
+    // as PianoXL.tsx does
+    const int newKey = getPitchClass(keyPitchClass);
+    if (mode != currentMode || (newKey != currentKey && mode != MusicMode::free))
+        clearBassOffsets();
+
+    currentKey = newKey;
+    currentMode = mode;
+    chordCycler.setScale(currentKey, currentMode);
+
+    // Only the keys whose highlight actually changes are repainted
+    scaleMask = getScaleMask(currentKey, currentMode);
+    keyboard.setScaleMask(scaleMask);
+
+    // setScale() put every slot back on its first chord
+    updateSlotLabels();
+
+    settingsPanel.setKey(currentKey);
+    settingsPanel.setMode(currentMode);
+
+    // What fits next depends on the key and mode
+    showSuggestions();
+
+    state.setProperty("key", currentKey, nullptr);
+    state.setProperty("mode", static_cast<int>(currentMode), nullptr);
+}
+
 MainComponent::~MainComponent()
 {
+    shutdownAudio();
     settingsPanel.removeListener(this);
+
+    // A take still running when the app quits is finished off like a normal one; the
+    // recorder waits for the bounce when the engine is destroyed
+    if (audioEngine.isRecording())
+    {
+        audioEngine.stopRecordingFromUI();
+        audioEngine.getRecorder().bounceToMidiAsync(nullptr);
+    }
     plusButton.setLookAndFeel(nullptr);
     minusButton.setLookAndFeel(nullptr);
 
@@ -233,12 +902,15 @@ void MainComponent::resized()
     float currentWhiteKeyX = pianoAreaTopLeft.getX() + (whiteKeysRowPaddingH * scaleFactor);
     float whiteKeysY = pianoAreaTopLeft.getY() + (whiteKeysRowTranslateY * scaleFactor);
 
-    for (size_t i = 0; i < whiteKeys.size(); ++i)
+    // Key rectangles in our coordinates, by pitch class, handed to the keyboard below
+    std::array<juce::Rectangle<float>, KeyboardComponent::numKeys> keyRects;
+
+    for (const int pitchClass : { 0, 2, 4, 5, 7, 9, 11 })
     {
-        whiteKeys[i]->setBounds(static_cast<int>(currentWhiteKeyX + scaledMarginH),
-                                static_cast<int>(whiteKeysY),
-                                static_cast<int>(scaledKeyWidth),
-                                static_cast<int>(scaledKeyHeight));
+        keyRects[static_cast<size_t>(pitchClass)] = juce::Rectangle<int>(static_cast<int>(currentWhiteKeyX + scaledMarginH),
+                                                                         static_cast<int>(whiteKeysY),
+                                                                         static_cast<int>(scaledKeyWidth),
+                                                                         static_cast<int>(scaledKeyHeight)).toFloat();
         // Advance X by key width + both margins (left and right)
         currentWhiteKeyX += scaledKeyWidth + (scaledMarginH * 2.0f);
     }
@@ -269,27 +941,33 @@ void MainComponent::resized()
     float blackKeysY = pianoAreaTopLeft.getY() + (whiteKeysRowTranslateY * scaleFactor) + 
                       (blackKeysRowOrigTop * scaleFactor) - scaledBlackKeysUpOffset; // Use scaled offset
 
-    size_t blackKeyInstanceIdx = 0;
-    for (const auto& noteName : blackKeyNotes)
+    // -1 is the gap between D# and F# (blackKeyPlaceholder)
+    for (const int pitchClass : { 1, 3, -1, 6, 8, 10 })
     {
-        if (!noteName.isEmpty())
+        if (pitchClass >= 0)
         {
-            if (blackKeyInstanceIdx < blackKeys.size())
-            {
-                blackKeys[blackKeyInstanceIdx]->setBounds(static_cast<int>(blackKeysCurrentX + scaledBlackKeyMarginH),
-                                                       static_cast<int>(blackKeysY),
-                                                       static_cast<int>(scaledBlackKeyWidth),
-                                                       static_cast<int>(scaledBlackKeyHeight));
-                blackKeysCurrentX += scaledBlackKeyWidth + (scaledBlackKeyMarginH * 2.0f);
-                blackKeyInstanceIdx++;
+            keyRects[static_cast<size_t>(pitchClass)] = juce::Rectangle<int>(static_cast<int>(blackKeysCurrentX + scaledBlackKeyMarginH),
+                                                                             static_cast<int>(blackKeysY),
+                                                                             static_cast<int>(scaledBlackKeyWidth),
+                                                                             static_cast<int>(scaledBlackKeyHeight)).toFloat();
+            blackKeysCurrentX += scaledBlackKeyWidth + (scaledBlackKeyMarginH * 2.0f);
         }
-    }
         else
         {
             blackKeysCurrentX += scaledBlackKeyPlaceholderWidth;
         }
     }
 
+    // One component spanning every key, with the keys relative to it
+    auto keyboardArea = keyRects[0];
+    for (const auto& rect : keyRects)
+        keyboardArea = keyboardArea.getUnion(rect);
+
+    keyboard.setBounds(keyboardArea.getSmallestIntegerContainer());
+
+    for (int pitchClass = 0; pitchClass < KeyboardComponent::numKeys; ++pitchClass)
+        keyboard.setKeyBounds(pitchClass, keyRects[static_cast<size_t>(pitchClass)] - keyboard.getPosition().toFloat());
+
     // --- Title Component Layout ---
     float titleOrigX = -71.0f; // Moved right by 50 to keep in frame
     float titleOrigY = -50.0f;
@@ -374,6 +1052,8 @@ void MainComponent::loadState()
         state.setProperty("inversion", 0, nullptr);
     if (!state.hasProperty("inversionSelected"))
         state.setProperty("inversionSelected", false, nullptr);
+    if (!state.hasProperty("voiceLeading"))
+        state.setProperty("voiceLeading", false, nullptr);
 }
 
 void MainComponent::saveState()
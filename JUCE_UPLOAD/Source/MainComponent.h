@@ -1,17 +1,24 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "PianoKeyComponent.h" 
+#include "KeyboardComponent.h"
 #include "TitleComponent.h"
 #include "VerticalFaderComponent.h"
 #include "SettingsPanelXLComponent.h"
+#include "AudioEngine.h"
+#include "ChordRecognizer.h"
+#include "ChordSuggestionEngine.h"
+#include "ChordCycler.h"
+#include "VoicingEngine.h"
+#include "MidiFileImporter.h"
 
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent  : public juce::Component,
+class MainComponent  : public juce::AudioAppComponent,
+                      public juce::FileDragAndDropTarget,
                       public SettingsPanelXLComponent::Listener
 {
 public:
@@ -22,7 +29,27 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    bool keyPressed(const juce::KeyPress& key) override;
     void inversionSelectionChanged(bool isSelected, int value) override;
+    void voiceLeadingChanged(bool shouldLeadVoices) override;
+    void instrumentChanged(InstrumentType instrument) override;
+    void selectedControlChanged(const juce::String& control) override;
+    void modeChanged(MusicMode mode) override;
+    void recordButtonClicked() override;
+    void memoryButtonClicked() override;
+    void recordAudioChanged(bool shouldRecordAudio) override;
+    void bassOffsetChanged(int semitones) override;
+    void flamChanged(FlamValue flam) override;
+    void releaseModelChanged(EnvelopeBank::ReleaseModel model) override;
+
+    // Dropping a folder imports its MIDI files (see importMidiFolder)
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
 
 private:
     //==============================================================================
@@ -41,14 +68,30 @@ private:
 
     juce::Rectangle<int> contentBounds;
 
-    // Test Piano Key
-    // PianoKeyComponent testKey; // Will be replaced by arrays of keys
+    // Merges the repaints of each frame's key and panel changes into one pass per vblank
+    RepaintBatcher repaintBatcher { *this };
 
     // Other UI Elements
     TitleComponent titleComponent;
     VerticalFaderComponent verticalFader;
     SettingsPanelXLComponent settingsPanel;
 
+    // Voice engine driven by the piano keys
+    AudioEngine audioEngine;
+
+    // Names the notes each key plays for the settings panel's chord display
+    ChordRecognizer chordRecognizer;
+
+    // Likely next chords after the one just recognized, in the current key and mode
+    ChordSuggestionEngine suggestionEngine;
+
+    // Chord type each key plays, stepped with plus/minus while CHORD is selected
+    ChordCycler chordCycler;
+    int lastPlayedSlot = -1;
+
+    // Applies INV (and optional voice leading) to each chord before it's played
+    VoicingEngine voicingEngine;
+
     // ValueTree to store persistent state
     juce::ValueTree state { "AppState" };
 
@@ -83,14 +126,81 @@ private:
     juce::TextButton plusButton;
     juce::TextButton minusButton;
 
-    // Piano Keys
-    std::vector<std::unique_ptr<PianoKeyComponent>> whiteKeys;
-    std::vector<std::unique_ptr<PianoKeyComponent>> blackKeys;
-
-    // Key names (using "Db" for "C#" etc. for easier processing if needed, but display can be "#")
-    const juce::String whiteKeyNotes[7] = {"C", "D", "E", "F", "G", "A", "B"};
-    // Using nullptrs for spacing in black key array based on PianoXL.tsx structure
-    const juce::String blackKeyNotes[6] = {"C#", "D#", "", "F#", "G#", "A#"}; // "" for placeholder
+    // Piano keys, all twelve painted and hit-tested by one component
+    KeyboardComponent keyboard;
+
+    // Current key and mode, and the pitch classes of their scale
+    int currentKey = 0;
+    MusicMode currentMode = MusicMode::free;
+    juce::uint16 scaleMask = getScaleMask(0, MusicMode::free);
+
+    // MIDI note for a key, in the octave starting at middle C
+    static int getMidiNoteForKey(int pitchClass);
+
+    // Bass note played with a key, optionally offset as by the bass offset buttons
+    static int getBassNoteForKey(int pitchClass, int bassOffset = 0);
+
+    // Plays a key section's chord and bass note for as long as the finger holds it,
+    // and shows the chord they form
+    void playKey(int pitchClass, int section, int finger);
+
+    // Engine state as it's heard: once per vblank, lights the sounding keys and
+    // names their chord, held back by the output latency
+    EngineStateDelay engineStateDelay;
+    void showEngineState();
+
+    // The last chord heard, and the panel's list of likely next chords after it
+    RecognizedChord lastHeardChord;
+    void showSuggestions();
+    double getOutputLatencyMs();
+
+    // Starts or stops the loaded progression (space bar)
+    void setProgressionPlaying(bool shouldPlay);
+    bool progressionPlaying = false;
+
+    // The library as one song, each imported song a section (ArrangementEngine): A plays
+    // it from the current song's first bar, L loops that song, space stops it
+    void arrangeLibrary();
+    void setArrangementPlaying(bool shouldPlay);
+    void setSectionLooping(bool shouldLoop);
+    std::vector<int> sectionFirstBars;      // per song, then the bar after the last
+    bool arrangementPlaying = false;
+    bool sectionLooping = false;
+
+    // Measurement mode (PIANOXL_MEASURE_LATENCY): press-to-first-sample times, plus the device's share
+    void logLatencyMeasurements();
+
+    // Names the chord each split-key section plays, as PianoXL shows in XXL/XXXL
+    void updateSlotLabel(int slot);
+    void updateSlotLabels();
+
+    // Bass offset of each key slot, as chordBassOffsets in PianoXL.tsx; the bass clef
+    // button edits the last slot played. Saved in the state as one string.
+    std::array<int, ChordCycler::numSlots> bassOffsets {};
+    void clearBassOffsets();
+    void saveBassOffsets();
+    void loadBassOffsets(const juce::String& savedOffsets);
+
+    // Steps the chord type of the last key played and shows the new chord
+    void cycleLastChordType(int direction);
+
+    // Sets the sustain (10-200%) for the engine and the panel's SUS display
+    void setSustain(int percent);
+
+    // Switches key and mode, updating only the key highlights that change
+    void setScale(int keyPitchClass, MusicMode mode);
+
+    // Imports a folder of MIDI files in the background, logs how it went, adds its
+    // songs to the library and plays the first of them
+    void importMidiFolder(const juce::File& directory);
+    void midiFolderImported(const MidiFileImporter::Stats& stats, std::vector<MidiFileImporter::Result> results);
+    juce::ThreadPool importPool { 1 };
+
+    // Every song imported so far, and the one loaded into the progression player.
+    // Chords keep their lengths and bass notes (see AudioEngine::loadProgressionFromUI).
+    std::vector<MidiFileImporter::Result> progressionLibrary;
+    int currentProgression = -1;
+    void loadLibraryProgression(int index);
 
     // Persistence helpers
     void loadState();
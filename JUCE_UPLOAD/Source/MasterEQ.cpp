@@ -0,0 +1,220 @@
+#include "MasterEQ.h"
+
+MasterEQ::MasterEQ()
+{
+    reset();
+}
+
+void MasterEQ::prepare(double newSampleRate, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto& band = bands[static_cast<size_t>(i)];
+        const float gain = band.gainDb.getTargetValue();
+
+        // 20 ms ramps are short enough to feel immediate and long enough to be click-free
+        band.gainDb.reset(sampleRate, 0.02);
+        band.gainDb.setCurrentAndTargetValue(gain);
+        band.current = makeCoefficients(static_cast<Band>(i), sampleRate, gain);
+        band.increment = {};
+    }
+
+    reset();
+}
+
+void MasterEQ::reset()
+{
+    for (auto& band : bands)
+    {
+        band.z1.fill(Vec::expand(0.0f));
+        band.z2.fill(Vec::expand(0.0f));
+    }
+}
+
+void MasterEQ::setBandGain(Band band, float gainDb)
+{
+    bands[static_cast<size_t>(band)].gainDb.setTargetValue(juce::jlimit(-maxGainDb, maxGainDb, gainDb));
+}
+
+float MasterEQ::getBandGain(Band band) const
+{
+    return bands[static_cast<size_t>(band)].gainDb.getTargetValue();
+}
+
+MasterEQ::Coefficients MasterEQ::makeCoefficients(Band band, double sampleRate, float gainDb)
+{
+    // RBJ cookbook filters, the same designs Web Audio's BiquadFilterNode uses
+    const double frequency = band == Band::low ? 320.0 : (band == Band::mid ? 1000.0 : 3200.0);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double w0 = juce::MathConstants<double>::twoPi * juce::jmin(frequency, sampleRate * 0.45) / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double sinW0 = std::sin(w0);
+
+    double b0, b1, b2, a0, a1, a2;
+
+    if (band == Band::mid)
+    {
+        const double alpha = sinW0 / 2.0; // Q = 1
+        b0 = 1.0 + alpha * A;
+        b1 = -2.0 * cosW0;
+        b2 = 1.0 - alpha * A;
+        a0 = 1.0 + alpha / A;
+        a1 = -2.0 * cosW0;
+        a2 = 1.0 - alpha / A;
+    }
+    else
+    {
+        // Shelf slope of 1
+        const double twoSqrtAAlpha = 2.0 * std::sqrt(A) * sinW0 / 2.0 * juce::MathConstants<double>::sqrt2;
+        const double sign = band == Band::low ? -1.0 : 1.0;
+
+        b0 = A * ((A + 1.0) + sign * (A - 1.0) * cosW0 + twoSqrtAAlpha);
+        b1 = -2.0 * sign * A * ((A - 1.0) + sign * (A + 1.0) * cosW0);
+        b2 = A * ((A + 1.0) + sign * (A - 1.0) * cosW0 - twoSqrtAAlpha);
+        a0 = (A + 1.0) - sign * (A - 1.0) * cosW0 + twoSqrtAAlpha;
+        a1 = 2.0 * sign * ((A - 1.0) - sign * (A + 1.0) * cosW0);
+        a2 = (A + 1.0) - sign * (A - 1.0) * cosW0 - twoSqrtAAlpha;
+    }
+
+    Coefficients c;
+    c.b0 = static_cast<float>(b0 / a0);
+    c.b1 = static_cast<float>(b1 / a0);
+    c.b2 = static_cast<float>(b2 / a0);
+    c.a1 = static_cast<float>(a1 / a0);
+    c.a2 = static_cast<float>(a2 / a0);
+    return c;
+}
+
+bool MasterEQ::isBypassed() const
+{
+    for (const auto& band : bands)
+        if (band.gainDb.isSmoothing() || band.gainDb.getTargetValue() != 0.0f)
+            return false;
+
+    return true;
+}
+
+void MasterEQ::updateControlInterval(int numSamples)
+{
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto& band = bands[static_cast<size_t>(i)];
+
+        if (!band.gainDb.isSmoothing())
+        {
+            band.increment = {};
+            continue;
+        }
+
+        // Recompute at the end of the interval and step the coefficients towards it per sample
+        band.gainDb.skip(numSamples);
+        const auto target = makeCoefficients(static_cast<Band>(i), sampleRate, band.gainDb.getCurrentValue());
+        const float scale = 1.0f / static_cast<float>(numSamples);
+
+        band.increment.b0 = (target.b0 - band.current.b0) * scale;
+        band.increment.b1 = (target.b1 - band.current.b1) * scale;
+        band.increment.b2 = (target.b2 - band.current.b2) * scale;
+        band.increment.a1 = (target.a1 - band.current.a1) * scale;
+        band.increment.a2 = (target.a2 - band.current.a2) * scale;
+    }
+}
+
+void MasterEQ::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (isBypassed())
+        return;
+
+    const int groups = (juce::jmin(numChannels, buffer.getNumChannels()) + (int) Vec::SIMDNumElements - 1) / (int) Vec::SIMDNumElements;
+
+    for (int offset = 0; offset < numSamples; offset += controlInterval)
+    {
+        const int chunk = juce::jmin(controlInterval, numSamples - offset);
+
+        updateControlInterval(chunk);
+
+        for (int group = 0; group < groups; ++group)
+            processGroup(buffer, group, startSample + offset, chunk);
+
+        // Every group stepped its own copy of the coefficients; commit the end values
+        for (auto& band : bands)
+        {
+            band.current.b0 += band.increment.b0 * static_cast<float>(chunk);
+            band.current.b1 += band.increment.b1 * static_cast<float>(chunk);
+            band.current.b2 += band.increment.b2 * static_cast<float>(chunk);
+            band.current.a1 += band.increment.a1 * static_cast<float>(chunk);
+            band.current.a2 += band.increment.a2 * static_cast<float>(chunk);
+        }
+    }
+
+    // Once everything has settled back to flat, drop the filter state so the next
+    // move starts clean
+    if (isBypassed())
+        reset();
+}
+
+void MasterEQ::processGroup(juce::AudioBuffer<float>& buffer, int group, int startSample, int numSamples)
+{
+    constexpr int lanes = (int) Vec::SIMDNumElements;
+    const int firstChannel = group * lanes;
+    const int channelsInGroup = juce::jmin(lanes, juce::jmin(numChannels, buffer.getNumChannels()) - firstChannel);
+
+    std::array<float*, lanes> channelData {};
+    for (int lane = 0; lane < channelsInGroup; ++lane)
+        channelData[static_cast<size_t>(lane)] = buffer.getWritePointer(firstChannel + lane, startSample);
+
+    std::array<Coefficients, numBands> c;
+    std::array<Vec, numBands> z1, z2;
+
+    for (size_t b = 0; b < static_cast<size_t>(numBands); ++b)
+    {
+        c[b] = bands[b].current;
+        z1[b] = bands[b].z1[static_cast<size_t>(group)];
+        z2[b] = bands[b].z2[static_cast<size_t>(group)];
+    }
+
+    // Channels side by side, one aligned register per sample; spare lanes run on silence
+    float* const frames = interleaved.data();
+
+    if (channelsInGroup < lanes)
+        std::fill(frames, frames + numSamples * lanes, 0.0f);
+
+    for (int lane = 0; lane < channelsInGroup; ++lane)
+        for (int i = 0; i < numSamples; ++i)
+            frames[i * lanes + lane] = channelData[static_cast<size_t>(lane)][i];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto x = Vec::fromRawArray(frames + i * lanes);
+
+        // Transposed direct form II, low -> mid -> high
+        for (size_t b = 0; b < static_cast<size_t>(numBands); ++b)
+        {
+            const auto y = x * c[b].b0 + z1[b];
+            z1[b] = x * c[b].b1 - y * c[b].a1 + z2[b];
+            z2[b] = x * c[b].b2 - y * c[b].a2;
+            x = y;
+
+            const auto& inc = bands[b].increment;
+            c[b].b0 += inc.b0;
+            c[b].b1 += inc.b1;
+            c[b].b2 += inc.b2;
+            c[b].a1 += inc.a1;
+            c[b].a2 += inc.a2;
+        }
+
+        x.copyToRawArray(frames + i * lanes);
+    }
+
+    for (int lane = 0; lane < channelsInGroup; ++lane)
+        for (int i = 0; i < numSamples; ++i)
+            channelData[static_cast<size_t>(lane)][i] = frames[i * lanes + lane];
+
+    for (size_t b = 0; b < static_cast<size_t>(numBands); ++b)
+    {
+        bands[b].z1[static_cast<size_t>(group)] = z1[b];
+        bands[b].z2[static_cast<size_t>(group)] = z2[b];
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/*
+    Three-band master EQ, the native counterpart of lowEQ/midEQ/highEQ in
+    audio-utils.ts (low shelf 320 Hz, peak 1 kHz Q 1, high shelf 3.2 kHz, +-12 dB).
+
+    The three biquads run as one cascade with channels packed into the lanes of a
+    SIMD register, so a stereo bus costs one vector pass per sample. Each chunk is
+    interleaved into aligned scratch once, the way the dsp module's SIMD examples
+    feed an AudioBlock<SIMDRegister>, so the filter loop only does aligned loads and
+    stores. Coefficients
+    are only recomputed while a band's gain is moving. That happens at a control
+    rate, and the coefficients are interpolated linearly per sample in between, so
+    automation doesn't produce zipper noise. With every band flat and settled, the
+    EQ is skipped entirely.
+*/
+class MasterEQ
+{
+public:
+    enum class Band
+    {
+        low,
+        mid,
+        high
+    };
+
+    static constexpr int numBands = 3;
+    static constexpr float maxGainDb = 12.0f;
+
+    MasterEQ();
+
+    void prepare(double newSampleRate, int newNumChannels);
+    void reset();
+
+    // Audio thread: sets a band's target gain, clamped to +-12 dB like setEqBand()
+    void setBandGain(Band band, float gainDb);
+    float getBandGain(Band band) const;
+
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxChannels = 8;
+    static constexpr int maxChannelGroups = (maxChannels + (int) Vec::SIMDNumElements - 1) / (int) Vec::SIMDNumElements;
+    static constexpr int controlInterval = 32;
+
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    struct BandState
+    {
+        juce::SmoothedValue<float> gainDb;
+        Coefficients current;
+        Coefficients increment;
+        std::array<Vec, maxChannelGroups> z1;
+        std::array<Vec, maxChannelGroups> z2;
+    };
+
+    static Coefficients makeCoefficients(Band band, double sampleRate, float gainDb);
+    bool isBypassed() const;
+    void updateControlInterval(int numSamples);
+    void processGroup(juce::AudioBuffer<float>& buffer, int group, int startSample, int numSamples);
+
+    std::array<BandState, numBands> bands;
+
+    // One control interval of a channel group, a register's worth of floats per sample
+    alignas(Vec::SIMDRegisterSize) std::array<float, controlInterval * Vec::SIMDNumElements> interleaved;
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MasterEQ)
+};
@@ -0,0 +1,380 @@
+#include "MidiFileImporter.h"
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    constexpr int drumChannel = 9;      // channel 10, zero-based
+
+    // Bounds-checked big-endian reader over a byte range; a failed read sticks
+    struct ByteReader
+    {
+        const juce::uint8* data = nullptr;
+        size_t size = 0;
+        size_t position = 0;
+        bool failed = false;
+
+        bool isFinished() const             { return failed || position >= size; }
+        size_t getRemaining() const         { return size - juce::jmin(position, size); }
+
+        int readByte()
+        {
+            if (isFinished())
+            {
+                failed = true;
+                return 0;
+            }
+
+            return data[position++];
+        }
+
+        juce::uint32 readBigEndian(int numBytes)
+        {
+            juce::uint32 value = 0;
+            for (int i = 0; i < numBytes; ++i)
+                value = (value << 8) | static_cast<juce::uint32>(readByte());
+
+            return value;
+        }
+
+        juce::uint32 readVariableLength()
+        {
+            juce::uint32 value = 0;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const int byte = readByte();
+                value = (value << 7) | static_cast<juce::uint32>(byte & 0x7f);
+
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+
+            failed = true;
+            return value;
+        }
+
+        const juce::uint8* skip(size_t numBytes)
+        {
+            if (numBytes > getRemaining())
+            {
+                failed = true;
+                return nullptr;
+            }
+
+            const auto* start = data + position;
+            position += numBytes;
+            return start;
+        }
+    };
+
+    struct FileInfo
+    {
+        juce::String name;
+        juce::uint32 microsecondsPerQuarter = 500000;
+        int beatsPerBar = 4;
+        int beatUnitPower = 2;
+        bool hasTempo = false;
+        bool hasTimeSignature = false;
+        juce::uint32 endTick = 0;
+    };
+
+    void parseTrack(ByteReader track, FileInfo& info, std::vector<MidiFileImporter::NoteOnset>& onsets)
+    {
+        juce::uint32 tick = 0;
+        int runningStatus = 0;
+
+        while (!track.isFinished())
+        {
+            tick += track.readVariableLength();
+            info.endTick = juce::jmax(info.endTick, tick);
+
+            int status = track.readByte();
+            if (track.failed)
+                return;
+
+            if (status < 0x80)
+            {
+                // Running status: that byte was the first data byte
+                if (runningStatus == 0)
+                    return;
+
+                status = runningStatus;
+                --track.position;
+            }
+
+            if (status == 0xff)
+            {
+                const int type = track.readByte();
+                const auto length = track.readVariableLength();
+                const auto* payload = track.skip(length);
+
+                if (payload == nullptr || type == 0x2f)
+                    return;
+
+                if (type == 0x03 && info.name.isEmpty())
+                    info.name = juce::String::fromUTF8(reinterpret_cast<const char*>(payload), static_cast<int>(length));
+                else if (type == 0x51 && length == 3 && !info.hasTempo)
+                {
+                    info.microsecondsPerQuarter = (static_cast<juce::uint32>(payload[0]) << 16)
+                                                | (static_cast<juce::uint32>(payload[1]) << 8) | payload[2];
+                    info.hasTempo = info.microsecondsPerQuarter > 0;
+                }
+                else if (type == 0x58 && length >= 2 && !info.hasTimeSignature)
+                {
+                    info.beatsPerBar = juce::jlimit(1, 32, static_cast<int>(payload[0]));
+                    info.beatUnitPower = juce::jlimit(0, 5, static_cast<int>(payload[1]));
+                    info.hasTimeSignature = true;
+                }
+
+                // Meta and SysEx events cancel running status
+                runningStatus = 0;
+            }
+            else if (status == 0xf0 || status == 0xf7)
+            {
+                track.skip(track.readVariableLength());
+                runningStatus = 0;
+            }
+            else if (status >= 0xf0)
+            {
+                // System common/real-time bytes don't belong in a file; stop rather than misread
+                return;
+            }
+            else
+            {
+                runningStatus = status;
+
+                const int type = status & 0xf0;
+                const int data1 = track.readByte();
+                const int data2 = (type == 0xc0 || type == 0xd0) ? 0 : track.readByte();
+
+                if (type == 0x90 && data2 > 0 && (status & 0x0f) != drumChannel && !track.failed)
+                    onsets.push_back({ tick, static_cast<juce::uint8>(data1 & 0x7f), static_cast<juce::uint8>(data2) });
+            }
+        }
+    }
+}
+
+//==============================================================================
+MidiFileImporter::MidiFileImporter()
+{
+}
+
+bool MidiFileImporter::importFile(const juce::File& file, Result& result) const
+{
+    std::vector<NoteOnset> onsets;
+    return importFile(file, result, onsets);
+}
+
+bool MidiFileImporter::importData(const void* data, size_t numBytes, Result& result) const
+{
+    std::vector<NoteOnset> onsets;
+    return importData(data, numBytes, result, onsets);
+}
+
+bool MidiFileImporter::importFile(const juce::File& file, Result& result, std::vector<NoteOnset>& onsets) const
+{
+    result.file = file;
+
+    const juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+    if (mappedFile.getData() == nullptr)
+    {
+        result.imported = false;
+        return false;
+    }
+
+    if (!importData(mappedFile.getData(), mappedFile.getSize(), result, onsets))
+        return false;
+
+    if (result.progression.name.isEmpty())
+        result.progression.name = file.getFileNameWithoutExtension();
+
+    return true;
+}
+
+bool MidiFileImporter::importData(const void* data, size_t numBytes, Result& result, std::vector<NoteOnset>& onsets) const
+{
+    result.imported = false;
+    result.progression = {};
+    result.chordNames.clear();
+    onsets.clear();
+
+    ByteReader reader { static_cast<const juce::uint8*>(data), numBytes };
+
+    if (reader.readBigEndian(4) != 0x4d546864)     // MThd
+        return false;
+
+    const auto headerLength = reader.readBigEndian(4);
+    reader.readBigEndian(2);                        // format: tracks are merged either way
+    const auto numTracks = reader.readBigEndian(2);
+    const auto division = reader.readBigEndian(2);
+    reader.skip(headerLength > 6 ? headerLength - 6 : 0);
+
+    // SMPTE time has no beats to hang chords on
+    if (reader.failed || headerLength < 6 || division == 0 || (division & 0x8000) != 0)
+        return false;
+
+    FileInfo info;
+
+    for (juce::uint32 track = 0; track < numTracks && !reader.isFinished();)
+    {
+        const auto chunkType = reader.readBigEndian(4);
+        const auto chunkLength = static_cast<size_t>(reader.readBigEndian(4));
+
+        // A truncated last track still gets whatever it has
+        const auto available = juce::jmin(chunkLength, reader.getRemaining());
+        const auto* chunk = reader.skip(available);
+
+        if (reader.failed)
+            break;
+
+        if (chunkType == 0x4d54726b)               // MTrk; other chunks are skipped
+        {
+            parseTrack({ chunk, available }, info, onsets);
+            ++track;
+        }
+    }
+
+    const int ticksPerQuarterNote = static_cast<int>(division);
+    const int beatUnit = 1 << info.beatUnitPower;
+
+    auto& progression = result.progression;
+    progression.name = info.name.trim();
+    progression.beatsPerBar = info.beatsPerBar;
+    progression.beatUnit = beatUnit;
+    progression.bpm = 60000000.0 / info.microsecondsPerQuarter * beatUnit / 4.0;
+
+    extractChords(onsets, info.endTick, ticksPerQuarterNote, juce::jmax(1, ticksPerQuarterNote * 4 / beatUnit), result);
+
+    result.imported = !progression.chords.empty();
+    return result.imported;
+}
+
+void MidiFileImporter::extractChords(std::vector<NoteOnset>& onsets, juce::uint32 endTick, int ticksPerQuarterNote,
+                                     int ticksPerBeat, Result& result) const
+{
+    // Tracks were appended one after another, so merge them by time
+    std::sort(onsets.begin(), onsets.end(), [] (const NoteOnset& a, const NoteOnset& b)
+    {
+        return a.tick != b.tick ? a.tick < b.tick : a.note < b.note;
+    });
+
+    const auto window = static_cast<juce::uint32>(juce::jmax(1, ticksPerQuarterNote / 16));
+    auto& chords = result.progression.chords;
+    juce::uint32 chordStart = 0;
+
+    for (size_t first = 0; first < onsets.size();)
+    {
+        const auto clusterStart = onsets[first].tick;
+        size_t last = first;
+        while (last < onsets.size() && onsets[last].tick - clusterStart <= window)
+            ++last;
+
+        // Onsets within the window may be out of pitch order
+        std::sort(onsets.begin() + static_cast<std::ptrdiff_t>(first), onsets.begin() + static_cast<std::ptrdiff_t>(last),
+                  [] (const NoteOnset& a, const NoteOnset& b) { return a.note < b.note; });
+
+        MidiExportChord chord;
+        size_t upper = first;
+
+        // A lowest note at least an octave under the rest is a bass line
+        const auto* secondNote = std::find_if(onsets.data() + first, onsets.data() + last,
+                                              [&] (const NoteOnset& onset) { return onset.note != onsets[first].note; });
+
+        if (secondNote != onsets.data() + last && secondNote->note - onsets[first].note >= 12)
+        {
+            chord.bassNote = onsets[first].note;
+            upper = static_cast<size_t>(secondNote - onsets.data());
+        }
+
+        juce::uint16 mask = 0;          // every note, for recognition
+        juce::uint16 chordMask = 0;     // the notes above the bass
+        int velocity = 0;
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const auto& onset = onsets[i];
+            const auto bit = static_cast<juce::uint16>(1 << getPitchClass(onset.note));
+            velocity = juce::jmax(velocity, static_cast<int>(onset.velocity));
+            mask = static_cast<juce::uint16>(mask | bit);
+
+            if (i >= upper && (chordMask & bit) == 0 && chord.notes.numNotes < ChordDescriptor::maxIntervals)
+            {
+                chord.notes.notes[static_cast<size_t>(chord.notes.numNotes++)] = onset.note;
+                chordMask = static_cast<juce::uint16>(chordMask | bit);
+            }
+        }
+
+        chord.velocity = static_cast<juce::uint8>(velocity);
+
+        const auto name = recognizer.recognize(mask, getPitchClass(onsets[first].note));
+        first = last;
+
+        // Not a chord, or the same chord struck again: the previous chord carries on
+        if (!name.isValid() || (!chords.empty() && result.chordNames.back() == name))
+            continue;
+
+        if (!chords.empty())
+            chords.back().beats = static_cast<double>(clusterStart - chordStart) / ticksPerBeat;
+
+        chords.push_back(chord);
+        result.chordNames.push_back(name);
+        chordStart = clusterStart;
+    }
+
+    if (!chords.empty())
+        chords.back().beats = static_cast<double>(juce::jmax(endTick, chordStart + 1) - chordStart) / ticksPerBeat;
+}
+
+MidiFileImporter::Stats MidiFileImporter::importDirectory(const juce::File& directory, std::vector<Result>& results,
+                                                          int numThreads) const
+{
+    const auto files = directory.findChildFiles(juce::File::findFiles, true, "*.mid;*.midi");
+
+    Stats stats;
+    stats.numFiles = files.size();
+    results.clear();
+    results.resize(static_cast<size_t>(stats.numFiles));
+
+    if (stats.numFiles == 0)
+        return stats;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    const int numWorkers = juce::jlimit(1, stats.numFiles, numThreads);
+
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> numRunning { numWorkers };
+    juce::WaitableEvent finished;
+
+    {
+        juce::ThreadPool pool(numWorkers);
+
+        // One job per worker pulling file indices, rather than one job per file
+        for (int worker = 0; worker < numWorkers; ++worker)
+        {
+            pool.addJob([&]
+            {
+                std::vector<NoteOnset> onsets;
+                onsets.reserve(4096);
+
+                for (int index = nextFile++; index < stats.numFiles; index = nextFile++)
+                    importFile(files.getReference(index), results[static_cast<size_t>(index)], onsets);
+
+                if (--numRunning == 0)
+                    finished.signal();
+            });
+        }
+
+        finished.wait(-1);
+    }
+
+    stats.seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    for (const auto& result : results)
+    {
+        stats.numImported += result.imported ? 1 : 0;
+        stats.numChords += static_cast<int>(result.progression.chords.size());
+    }
+
+    return stats;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "ChordRecognizer.h"
+#include "MidiFileWriter.h"
+
+//==============================================================================
+/*
+    Standard MIDI File import, the counterpart to MidiFileWriter. The reference
+    had no import path at all.
+
+    Files are memory-mapped and parsed in place, with running status, SysEx and
+    meta events handled and every read bounds-checked. Only the note onsets are
+    copied out, into a scratch list reused from file to file.
+
+    Chord extraction merges the onsets of all tracks and groups notes that
+    start within a 64th note of each other into clusters. A cluster becomes a
+    chord when ChordRecognizer can name it:
+      - each pitch class is kept once, from the lowest note upwards, up to
+        the six notes a ChordNotes holds
+      - a lowest note an octave or more below the rest becomes the bass note
+      - a chord lasts until the next one starts
+    Clusters that don't make a chord, such as single melody notes, just extend
+    the chord before them. Drums on channel 10 are ignored.
+
+    importDirectory() spreads a folder of files over a thread pool. Each worker
+    pulls the next file index and has its own scratch list, and the chord
+    table is shared read-only.
+*/
+class MidiFileImporter
+{
+public:
+    struct Result
+    {
+        juce::File file;
+        bool imported = false;
+        MidiExportProgression progression;
+        std::vector<RecognizedChord> chordNames;    // one per progression chord
+    };
+
+    struct Stats
+    {
+        int numFiles = 0;
+        int numImported = 0;
+        int numChords = 0;
+        double seconds = 0.0;
+
+        double getFilesPerSecond() const { return seconds > 0.0 ? numFiles / seconds : 0.0; }
+    };
+
+    MidiFileImporter();
+
+    bool importFile(const juce::File& file, Result& result) const;
+
+    // Parses an SMF already in memory; data isn't copied
+    bool importData(const void* data, size_t numBytes, Result& result) const;
+
+    // Imports every .mid/.midi file under directory; results are in file order
+    Stats importDirectory(const juce::File& directory, std::vector<Result>& results,
+                          int numThreads = juce::SystemStats::getNumCpus()) const;
+
+    struct NoteOnset
+    {
+        juce::uint32 tick = 0;
+        juce::uint8 note = 0;
+        juce::uint8 velocity = 0;
+    };
+
+private:
+    bool importFile(const juce::File& file, Result& result, std::vector<NoteOnset>& onsets) const;
+    bool importData(const void* data, size_t numBytes, Result& result, std::vector<NoteOnset>& onsets) const;
+
+    void extractChords(std::vector<NoteOnset>& onsets, juce::uint32 endTick, int ticksPerQuarterNote,
+                       int ticksPerBeat, Result& result) const;
+
+    ChordRecognizer recognizer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiFileImporter)
+};
@@ -0,0 +1,333 @@
+#include "MidiFileWriter.h"
+#include <cmath>
+
+namespace
+{
+    constexpr int maxTextBytes = 127;
+    constexpr int chordChannel = 0;
+    constexpr int bassChannel = 1;
+
+    bool hasBassNote(const MidiExportChord& chord)
+    {
+        return juce::isPositiveAndBelow(chord.bassNote, 128);
+    }
+
+    bool hasBassNotes(const MidiExportProgression& progression)
+    {
+        for (const auto& chord : progression.chords)
+            if (hasBassNote(chord))
+                return true;
+
+        return false;
+    }
+
+    // The time signature's beat unit as a power of two, as the 0x58 meta event stores it
+    int getBeatUnitPower(int beatUnit)
+    {
+        int power = 0;
+        while (power < 5 && (1 << (power + 1)) <= beatUnit)
+            ++power;
+
+        return power;
+    }
+
+    int getTicksPerBeat(const MidiExportProgression& progression)
+    {
+        return MidiFileWriter::ticksPerQuarterNote * 4 / (1 << getBeatUnitPower(progression.beatUnit));
+    }
+
+    juce::uint32 getTick(double beat, int ticksPerBeat)
+    {
+        return static_cast<juce::uint32>(std::llround(beat * ticksPerBeat));
+    }
+
+    // Cuts on a character boundary so the meta text stays valid UTF-8
+    juce::String getMetaText(const juce::String& text)
+    {
+        auto result = text;
+        while (result.getNumBytesAsUTF8() > static_cast<size_t>(maxTextBytes))
+            result = result.dropLastCharacters(1);
+
+        return result;
+    }
+}
+
+//==============================================================================
+MidiFileWriter::MidiFileWriter()
+{
+}
+
+size_t MidiFileWriter::getMaximumSize(const MidiExportProgression& progression)
+{
+    constexpr size_t headerSize = 14;
+    constexpr size_t trackHeaderSize = 8;
+    constexpr size_t textEventSize = 4 + 2 + maxTextBytes;     // delta, meta type, length, text
+    constexpr size_t endOfTrackSize = 4;
+    constexpr size_t noteEventSize = 4 + 3;                     // longest delta plus status and data
+
+    const size_t metaTrack = trackHeaderSize + textEventSize + 7 + 8 + endOfTrackSize;
+    const size_t noteTrack = trackHeaderSize + textEventSize + 4 + endOfTrackSize;
+
+    size_t numNotes = 0;
+    for (const auto& chord : progression.chords)
+        numNotes += static_cast<size_t>(chord.notes.size() + (hasBassNote(chord) ? 1 : 0));
+
+    return headerSize + metaTrack + 2 * noteTrack + 2 * numNotes * noteEventSize;
+}
+
+const std::vector<juce::uint8>& MidiFileWriter::write(const MidiExportProgression& progression)
+{
+    buffer.clear();
+    buffer.reserve(getMaximumSize(progression));
+
+    const bool withBass = hasBassNotes(progression);
+
+    writeHeader(withBass ? 3 : 2);
+    writeMetaTrack(progression);
+    writeNoteTrack(progression, chordChannel, getInstrument(progression.instrument).midiProgram, false);
+
+    if (withBass)
+        writeNoteTrack(progression, bassChannel, bassMidiProgram, true);
+
+    jassert(buffer.size() <= getMaximumSize(progression));
+    return buffer;
+}
+
+const std::vector<juce::uint8>& MidiFileWriter::writeEvents(const juce::String& name, double bpm,
+                                                            const std::vector<MidiExportEvent>& events,
+                                                            const std::array<juce::uint8, 16>& programs)
+{
+    buffer.clear();
+    // Header, meta track, per-track overhead for 16 channels, longest encoding of each event
+    buffer.reserve(14 + (8 + 6 + maxTextBytes + 7 + 8 + 4) + 16 * (8 + 3 + 4) + events.size() * (4 + 3));
+
+    juce::uint16 usedChannels = 0;
+    for (const auto& event : events)
+        usedChannels = static_cast<juce::uint16>(usedChannels | (1 << (event.status & 0x0f)));
+
+    writeHeader(1 + juce::countNumberOfBits(static_cast<juce::uint32>(usedChannels)));
+    writeMetaTrack(name, bpm, 4, 4);
+
+    for (int channel = 0; channel < 16; ++channel)
+    {
+        if ((usedChannels & (1 << channel)) == 0)
+            continue;
+
+        const auto track = beginTrack();
+
+        writeVariableLength(0);
+        writeByte(0xc0 | channel);
+        writeByte(programs[static_cast<size_t>(channel)]);
+
+        juce::uint32 lastTick = 0;
+        for (const auto& event : events)
+        {
+            if ((event.status & 0x0f) != channel)
+                continue;
+
+            const auto tick = juce::jmax(event.tick, lastTick);
+            const int type = event.status & 0xf0;
+
+            writeVariableLength(tick - lastTick);
+            writeByte(event.status);
+            writeByte(event.data1 & 0x7f);
+
+            if (type != 0xc0 && type != 0xd0)
+                writeByte(event.data2 & 0x7f);
+
+            lastTick = tick;
+        }
+
+        endTrack(track);
+    }
+
+    return buffer;
+}
+
+bool MidiFileWriter::writeToFile(const MidiExportProgression& progression, const juce::File& file)
+{
+    const auto& bytes = write(progression);
+    return file.replaceWithData(bytes.data(), bytes.size());
+}
+
+int MidiFileWriter::exportAll(const std::vector<MidiExportProgression>& progressions, const juce::File& directory)
+{
+    if (!directory.createDirectory())
+        return 0;
+
+    int numWritten = 0;
+
+    for (size_t i = 0; i < progressions.size(); ++i)
+    {
+        const auto& progression = progressions[i];
+        auto name = juce::File::createLegalFileName(progression.name.trim());
+        if (name.isEmpty())
+            name = "Progression " + juce::String(static_cast<int>(i) + 1);
+
+        if (writeToFile(progression, directory.getNonexistentChildFile(name, ".mid", false)))
+            ++numWritten;
+    }
+
+    return numWritten;
+}
+
+//==============================================================================
+void MidiFileWriter::writeByte(int value)
+{
+    buffer.push_back(static_cast<juce::uint8>(value & 0xff));
+}
+
+void MidiFileWriter::writeBigEndian(juce::uint32 value, int numBytes)
+{
+    for (int shift = 8 * (numBytes - 1); shift >= 0; shift -= 8)
+        writeByte(static_cast<int>(value >> shift));
+}
+
+void MidiFileWriter::writeVariableLength(juce::uint32 value)
+{
+    // Seven bits per byte, most significant first, high bit set on all but the last
+    value &= 0x0fffffff;
+
+    int numBytes = 1;
+    while (numBytes < 4 && (value >> (7 * numBytes)) != 0)
+        ++numBytes;
+
+    for (int i = numBytes - 1; i > 0; --i)
+        writeByte(static_cast<int>(0x80 | ((value >> (7 * i)) & 0x7f)));
+
+    writeByte(static_cast<int>(value & 0x7f));
+}
+
+void MidiFileWriter::writeText(int metaType, const juce::String& text)
+{
+    const auto metaText = getMetaText(text);
+    const auto numBytes = metaText.getNumBytesAsUTF8();
+
+    writeVariableLength(0);
+    writeByte(0xff);
+    writeByte(metaType);
+    writeVariableLength(static_cast<juce::uint32>(numBytes));
+
+    const auto* utf8 = metaText.toRawUTF8();
+    buffer.insert(buffer.end(), utf8, utf8 + numBytes);
+}
+
+size_t MidiFileWriter::beginTrack()
+{
+    writeBigEndian(0x4d54726b, 4);     // MTrk
+    const auto lengthOffset = buffer.size();
+    writeBigEndian(0, 4);
+    return lengthOffset;
+}
+
+void MidiFileWriter::endTrack(size_t lengthOffset)
+{
+    writeVariableLength(0);
+    writeByte(0xff);
+    writeByte(0x2f);
+    writeByte(0x00);
+
+    const auto length = static_cast<juce::uint32>(buffer.size() - lengthOffset - 4);
+    for (int i = 0; i < 4; ++i)
+        buffer[lengthOffset + static_cast<size_t>(i)] = static_cast<juce::uint8>(length >> (24 - 8 * i));
+}
+
+void MidiFileWriter::writeHeader(int numTracks)
+{
+    // MThd: format 1, ticks per quarter note
+    writeBigEndian(0x4d546864, 4);
+    writeBigEndian(6, 4);
+    writeBigEndian(1, 2);
+    writeBigEndian(static_cast<juce::uint32>(numTracks), 2);
+    writeBigEndian(ticksPerQuarterNote, 2);
+}
+
+void MidiFileWriter::writeMetaTrack(const MidiExportProgression& progression)
+{
+    writeMetaTrack(progression.name.isNotEmpty() ? progression.name : juce::String("Chord Progression"),
+                   progression.bpm, progression.beatsPerBar, progression.beatUnit);
+}
+
+void MidiFileWriter::writeMetaTrack(const juce::String& name, double beatsPerMinute, int beatsPerBar, int beatUnit)
+{
+    const auto track = beginTrack();
+
+    writeText(0x03, name);
+
+    // Set tempo, in microseconds per quarter note
+    const int beatUnitPower = getBeatUnitPower(beatUnit);
+    const double bpm = juce::jlimit(20.0, 300.0, beatsPerMinute);
+    const auto microsecondsPerQuarter = static_cast<juce::uint32>(std::lround(60000000.0 / bpm * (1 << beatUnitPower) / 4.0));
+
+    writeVariableLength(0);
+    writeByte(0xff);
+    writeByte(0x51);
+    writeByte(0x03);
+    writeBigEndian(juce::jmin(microsecondsPerQuarter, static_cast<juce::uint32>(0xffffff)), 3);
+
+    // Time signature: 24 MIDI clocks per metronome click, 8 32nds per quarter
+    writeVariableLength(0);
+    writeByte(0xff);
+    writeByte(0x58);
+    writeByte(0x04);
+    writeByte(juce::jlimit(1, 32, beatsPerBar));
+    writeByte(beatUnitPower);
+    writeByte(24);
+    writeByte(8);
+
+    endTrack(track);
+}
+
+void MidiFileWriter::writeNoteTrack(const MidiExportProgression& progression, int channel, juce::uint8 program, bool bass)
+{
+    const auto track = beginTrack();
+
+    writeText(0x03, bass ? juce::String("Bass") : juce::String(getInstrument(progression.instrument).label));
+
+    writeVariableLength(0);
+    writeByte(0xc0 | channel);
+    writeByte(program);
+
+    const int ticksPerBeat = getTicksPerBeat(progression);
+    juce::uint32 lastTick = 0;
+    double beat = 0.0;
+
+    auto writeNote = [&] (juce::uint32 tick, int status, int note, int velocity)
+    {
+        const auto time = juce::jmax(tick, lastTick);
+        writeVariableLength(time - lastTick);
+        writeByte(status | channel);
+        writeByte(note & 0x7f);
+        writeByte(velocity & 0x7f);
+        lastTick = time;
+    };
+
+    for (const auto& chord : progression.chords)
+    {
+        // Ticks come from the running beat count, so rounding never accumulates
+        const auto startTick = getTick(beat, ticksPerBeat);
+        beat += juce::jmax(0.0, chord.beats);
+        const auto endTick = juce::jmax(startTick + 1, getTick(beat, ticksPerBeat));
+
+        const int velocity = juce::jlimit(1, 127, static_cast<int>(chord.velocity));
+
+        if (bass)
+        {
+            if (hasBassNote(chord))
+            {
+                writeNote(startTick, 0x90, chord.bassNote, velocity);
+                writeNote(endTick, 0x80, chord.bassNote, 0);
+            }
+
+            continue;
+        }
+
+        for (auto note : chord.notes)
+            writeNote(startTick, 0x90, note, velocity);
+
+        for (auto note : chord.notes)
+            writeNote(endTick, 0x80, note, 0);
+    }
+
+    endTrack(track);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "ChordTable.h"
+#include "InstrumentTable.h"
+
+//==============================================================================
+/*
+    Standard MIDI File export, replacing exportProgressionToMidi() (midi-utils.ts).
+
+    The reference built one Uint8Array per event and concatenated them, wrote
+    delta times as a single raw byte (anything of 128 ticks or more came out
+    wrong) and always used program 108. This writer streams every event straight
+    into one byte buffer. It reserves the buffer from an upper bound on the
+    file size, writes delta times and meta lengths as variable-length
+    quantities, and patches each MTrk length in place once the track is done.
+
+    Files are format 1:
+      - a tempo/meta track
+      - a chord track with the instrument's General MIDI program
+      - a bass track on its own channel, when any chord has a bass note
+
+    exportAll() writes a whole list of progressions in one pass. It reuses the
+    same buffer, so it only allocates when a file is larger than any before it.
+
+    writeEvents() takes raw channel messages instead, for performances that
+    aren't a list of chords. The events of each channel get their own track.
+*/
+struct MidiExportChord
+{
+    ChordNotes notes;
+    int bassNote = -1;                  // MIDI note, or -1 for none
+    double beats = 4.0;                 // ChordModifier.duration
+    juce::uint8 velocity = 100;         // ChordModifier.velocity
+};
+
+struct MidiExportProgression
+{
+    juce::String name;
+    std::vector<MidiExportChord> chords;
+    double bpm = 120.0;                 // beats of beatUnit per minute
+    int beatsPerBar = 4;                // TimeSignature
+    int beatUnit = 4;
+    InstrumentType instrument = InstrumentType::balafon;
+};
+
+// A channel message at an absolute tick, for writeEvents()
+struct MidiExportEvent
+{
+    juce::uint32 tick = 0;
+    juce::uint8 status = 0x90;          // message type and channel
+    juce::uint8 data1 = 0;
+    juce::uint8 data2 = 0;
+};
+
+class MidiFileWriter
+{
+public:
+    static constexpr int ticksPerQuarterNote = 96;
+
+    MidiFileWriter();
+
+    // The file's bytes; valid until the next write
+    const std::vector<juce::uint8>& write(const MidiExportProgression& progression);
+
+    bool writeToFile(const MidiExportProgression& progression, const juce::File& file);
+
+    // Events must be sorted by tick; programs[channel] is each track's General MIDI program
+    const std::vector<juce::uint8>& writeEvents(const juce::String& name, double bpm,
+                                                const std::vector<MidiExportEvent>& events,
+                                                const std::array<juce::uint8, 16>& programs);
+
+    // Writes each progression to directory/<name>.mid; returns how many were written
+    int exportAll(const std::vector<MidiExportProgression>& progressions, const juce::File& directory);
+
+private:
+    static size_t getMaximumSize(const MidiExportProgression& progression);
+
+    void writeByte(int value);
+    void writeBigEndian(juce::uint32 value, int numBytes);
+    void writeVariableLength(juce::uint32 value);
+    void writeText(int metaType, const juce::String& text);
+
+    size_t beginTrack();
+    void endTrack(size_t lengthOffset);
+
+    void writeHeader(int numTracks);
+    void writeMetaTrack(const juce::String& name, double bpm, int beatsPerBar, int beatUnit);
+    void writeMetaTrack(const MidiExportProgression& progression);
+    void writeNoteTrack(const MidiExportProgression& progression, int channel, juce::uint8 program, bool bass);
+
+    std::vector<juce::uint8> buffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiFileWriter)
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <utility>
+#include "InstrumentTable.h"
+
+//==============================================================================
+/*
+    Per-waveform oscillators for VoicePool.
+
+    Each waveform is its own specialization, and renderVoice<> is instantiated once
+    per instrument, so the sample loop never branches on the instrument type.
+    Saw and triangle are band-limited by PolyBLEP / PolyBLAMP. The step (or kink)
+    in the naive waveform is smoothed over the two samples around it, which
+    removes most of the aliasing without oversampling or wavetables.
+*/
+namespace OscillatorKernels
+{
+    // Residual of a band-limited step, for phase t in 0..1 and increment dt
+    inline float polyBlep(float t, float dt)
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0f;
+        }
+
+        if (t > 1.0f - dt)
+        {
+            t = (t - 1.0f) / dt;
+            return t * t + t + t + 1.0f;
+        }
+
+        return 0.0f;
+    }
+
+    // Residual of a band-limited ramp (the integral of polyBlep), for slope changes
+    inline float polyBlamp(float t, float dt)
+    {
+        if (t < dt)
+        {
+            t = t / dt - 1.0f;
+            return -t * t * t / 3.0f;
+        }
+
+        if (t > 1.0f - dt)
+        {
+            t = (t - 1.0f) / dt + 1.0f;
+            return t * t * t / 3.0f;
+        }
+
+        return 0.0f;
+    }
+
+    template <Waveform waveform>
+    struct Oscillator;
+
+    template <>
+    struct Oscillator<Waveform::sine>
+    {
+        static float sample(float t, float)
+        {
+            return std::sin(juce::MathConstants<float>::twoPi * t);
+        }
+    };
+
+    template <>
+    struct Oscillator<Waveform::saw>
+    {
+        static float sample(float t, float dt)
+        {
+            return 2.0f * t - 1.0f - polyBlep(t, dt);
+        }
+    };
+
+    template <>
+    struct Oscillator<Waveform::triangle>
+    {
+        static float sample(float t, float dt)
+        {
+            // Rises from -1 to 1 over the first half cycle; the kinks are at 0 and 0.5
+            const float naive = t < 0.5f ? 4.0f * t - 1.0f : 3.0f - 4.0f * t;
+            const float halfShifted = t < 0.5f ? t + 0.5f : t - 0.5f;
+            return naive + 4.0f * dt * (polyBlamp(t, dt) - polyBlamp(halfShifted, dt));
+        }
+    };
+
+    //==============================================================================
+    // Adds gains[i] * oscillator into out[0..numSamples), advancing phase (0..1)
+    template <InstrumentType instrument>
+    void renderVoice(double& phase, double increment, const float* gains, float* out, int numSamples)
+    {
+        using Osc = Oscillator<getInstrument(instrument).waveform>;
+        const float dt = static_cast<float>(increment);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            out[i] += gains[i] * Osc::sample(static_cast<float>(phase), dt);
+
+            phase += increment;
+            if (phase >= 1.0)
+                phase -= 1.0;
+        }
+    }
+
+    using RenderFunction = void (*)(double&, double, const float*, float*, int);
+
+    template <size_t... indices>
+    constexpr std::array<RenderFunction, sizeof...(indices)> makeRenderTable(std::index_sequence<indices...>)
+    {
+        return {{ &renderVoice<instrumentTable[indices].type>... }};
+    }
+
+    // One kernel per instrument, indexed by InstrumentType
+    inline constexpr auto renderFunctions = makeRenderTable(std::make_index_sequence<instrumentTable.size()>());
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "RepaintBatcher.h"
+
+//==============================================================================
+/*
+    A read-only text display for the settings panel.
+
+    juce::Label calls repaint() straight from setText(), setFont() and its other
+    setters, so its changes can't be collected by a RepaintBatcher. This draws
+    the same way (LookAndFeel_V4::drawLabel: background, text inside the border,
+    outline), but every setter only marks the label dirty, and only when
+    something actually changed.
+*/
+class PanelLabel : public juce::Component
+{
+public:
+    PanelLabel() = default;
+
+    void setRepaintBatcher(RepaintBatcher* newBatcher) { repaintBatcher = newBatcher; }
+
+    void setText(const juce::String& newText)
+    {
+        if (text != newText)
+        {
+            text = newText;
+            markDirty();
+        }
+    }
+
+    const juce::String& getText() const { return text; }
+
+    void setFont(const juce::Font& newFont)
+    {
+        font = newFont;
+        markDirty();
+    }
+
+    void setJustificationType(juce::Justification newJustification)
+    {
+        if (justification != newJustification)
+        {
+            justification = newJustification;
+            markDirty();
+        }
+    }
+
+    void setBorderSize(juce::BorderSize<int> newBorder)
+    {
+        if (border != newBorder)
+        {
+            border = newBorder;
+            markDirty();
+        }
+    }
+
+    void setTextColour(juce::Colour colour)         { setIfChanged(textColour, colour); }
+    void setBackgroundColour(juce::Colour colour)   { setIfChanged(backgroundColour, colour); }
+    void setOutlineColour(juce::Colour colour)      { setIfChanged(outlineColour, colour); }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(backgroundColour);
+
+        g.setColour(textColour.withMultipliedAlpha(isEnabled() ? 1.0f : 0.5f));
+        g.setFont(font);
+
+        const auto textArea = border.subtractedFrom(getLocalBounds());
+        g.drawFittedText(text, textArea, justification,
+                         juce::jmax(1, static_cast<int>(static_cast<float>(textArea.getHeight()) / font.getHeight())),
+                         0.7f);
+
+        g.setColour(outlineColour);
+        g.drawRect(getLocalBounds());
+    }
+
+private:
+    void markDirty() { RepaintBatcher::repaint(repaintBatcher, *this); }
+
+    void setIfChanged(juce::Colour& current, juce::Colour colour)
+    {
+        if (current != colour)
+        {
+            current = colour;
+            markDirty();
+        }
+    }
+
+    juce::String text;
+    juce::Font font { juce::FontOptions(15.0f) };
+    juce::Justification justification { juce::Justification::centredLeft };
+    juce::BorderSize<int> border { 1, 5, 1, 5 };      // juce::Label's default
+
+    juce::Colour textColour = juce::Colours::black;
+    juce::Colour backgroundColour = juce::Colours::transparentBlack;
+    juce::Colour outlineColour = juce::Colours::transparentBlack;
+
+    RepaintBatcher* repaintBatcher = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PanelLabel)
+};
@@ -0,0 +1,409 @@
+#include "PerformanceRecorder.h"
+#include "MidiFileWriter.h"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+namespace
+{
+    constexpr int writerIntervalMs = 10;
+    constexpr double summaryIntervalMs = 1000.0;
+    constexpr int audioFifoSamples = 1 << 16;
+    constexpr double bounceBpm = 120.0;
+
+    juce::uint8 toMidiVelocity(float velocity)
+    {
+        return static_cast<juce::uint8>(juce::jlimit(1, 127, juce::roundToInt(velocity * 127.0f)));
+    }
+}
+
+//==============================================================================
+PerformanceRecorder::PerformanceRecorder()
+{
+}
+
+PerformanceRecorder::~PerformanceRecorder()
+{
+    stop();
+    removeBounceJobs(true);
+    writerThread.stopThread(2000);
+}
+
+bool PerformanceRecorder::start(const juce::File& directory, double sampleRate, int numChannels, bool withAudio,
+                                InstrumentType instrument, juce::int64 startSample)
+{
+    stop();
+
+    if (!directory.createDirectory())
+        return false;
+
+    takeDirectory = directory;
+    takeSampleRate = sampleRate;
+    takeNumChannels = numChannels;
+    takeInstrument = instrument;
+    takeStartSample = startSample;
+
+    events.reset();
+    numDroppedEvents = 0;
+    numDroppedAudioBlocks = 0;
+    numRecordedSamples = 0;
+
+    {
+        const juce::ScopedLock sl(summaryLock);
+        summary = {};
+    }
+
+    getEventLogFile().deleteFile();
+    eventLog = std::make_unique<juce::FileOutputStream>(getEventLogFile());
+    if (eventLog->failedToOpen())
+    {
+        eventLog.reset();
+        return false;
+    }
+
+    if (!writerThread.isThreadRunning())
+        writerThread.startThread();
+
+    if (withAudio)
+    {
+        getAudioFile().deleteFile();
+
+        if (auto stream = getAudioFile().createOutputStream())
+        {
+            juce::WavAudioFormat wavFormat;
+
+            if (auto* writer = wavFormat.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels), 24, {}, 0))
+            {
+                stream.release();   // the writer owns it now
+                audioWriter = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer, writerThread, audioFifoSamples);
+            }
+        }
+    }
+
+    lastSummaryWriteMs = juce::Time::getMillisecondCounterHiRes();
+    writerThread.addTimeSliceClient(this);
+
+    // Everything above must be in place before the audio thread can see the take
+    active = true;
+    return true;
+}
+
+void PerformanceRecorder::stop()
+{
+    if (!active.exchange(false))
+        return;
+
+    // Wait out a block that saw the take still running
+    while (audioThreadInside.load())
+        juce::Thread::yield();
+
+    writerThread.removeTimeSliceClient(this);
+
+    // Writes out whatever audio is still in its FIFO
+    audioWriter.reset();
+
+    drainEvents();
+    eventLog->flush();
+    eventLog.reset();
+
+    writeSummary();
+}
+
+PerformanceRecorder::Summary PerformanceRecorder::getSummary() const
+{
+    const juce::ScopedLock sl(summaryLock);
+
+    auto result = summary;
+    result.numDroppedEvents = numDroppedEvents.load();
+    result.numDroppedAudioBlocks = numDroppedAudioBlocks.load();
+    result.seconds = static_cast<double>(numRecordedSamples.load()) / takeSampleRate;
+    return result;
+}
+
+//==============================================================================
+void PerformanceRecorder::beginBlock()
+{
+    // Announce the block first; stop() clears active and then waits for this flag
+    audioThreadInside = true;
+    blockActive = active.load();
+
+    if (!blockActive)
+        audioThreadInside = false;
+}
+
+void PerformanceRecorder::endBlock(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (!blockActive)
+        return;
+
+    if (audioWriter != nullptr)
+    {
+        // The FIFO never blocks; a full one loses the block and counts it
+        if (buffer.getNumChannels() < takeNumChannels
+            || !audioWriter->write(buffer.getArrayOfReadPointers(), numSamples))
+            ++numDroppedAudioBlocks;
+    }
+
+    numRecordedSamples += numSamples;
+
+    blockActive = false;
+    audioThreadInside = false;
+}
+
+void PerformanceRecorder::push(const Event& event)
+{
+    if (!events.push(event))
+        ++numDroppedEvents;
+}
+
+void PerformanceRecorder::recordNoteOn(juce::int64 samplePosition, int channel, int midiNote, float velocity)
+{
+    if (!blockActive)
+        return;
+
+    Event event;
+    event.samplePosition = juce::jmax(static_cast<juce::int64>(0), samplePosition - takeStartSample);
+    event.type = Event::Type::noteOn;
+    event.channel = static_cast<juce::uint8>(channel);
+    event.note = static_cast<juce::uint8>(midiNote & 0x7f);
+    event.velocity = toMidiVelocity(velocity);
+    push(event);
+}
+
+void PerformanceRecorder::recordNoteOff(juce::int64 samplePosition, int channel, int midiNote)
+{
+    if (!blockActive)
+        return;
+
+    Event event;
+    event.samplePosition = juce::jmax(static_cast<juce::int64>(0), samplePosition - takeStartSample);
+    event.type = Event::Type::noteOff;
+    event.channel = static_cast<juce::uint8>(channel);
+    event.note = static_cast<juce::uint8>(midiNote & 0x7f);
+    push(event);
+}
+
+void PerformanceRecorder::recordAllNotesOff(juce::int64 samplePosition)
+{
+    if (!blockActive)
+        return;
+
+    Event event;
+    event.samplePosition = juce::jmax(static_cast<juce::int64>(0), samplePosition - takeStartSample);
+    event.type = Event::Type::allNotesOff;
+    push(event);
+}
+
+void PerformanceRecorder::recordParameter(juce::int64 samplePosition, EngineParameter parameter, float value)
+{
+    if (!blockActive)
+        return;
+
+    Event event;
+    event.samplePosition = juce::jmax(static_cast<juce::int64>(0), samplePosition - takeStartSample);
+    event.type = Event::Type::parameterChange;
+    event.parameter = parameter;
+    event.value = value;
+    push(event);
+}
+
+//==============================================================================
+int PerformanceRecorder::useTimeSlice()
+{
+    drainEvents();
+
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    if (now - lastSummaryWriteMs >= summaryIntervalMs)
+    {
+        writeSummary();
+        lastSummaryWriteMs = now;
+    }
+
+    return writerIntervalMs;
+}
+
+void PerformanceRecorder::drainEvents()
+{
+    Summary drained;
+    Event event;
+
+    while (events.pop(event))
+    {
+        eventLog->write(&event, sizeof(event));
+
+        ++drained.numEvents;
+        drained.numNotes += event.type == Event::Type::noteOn ? 1 : 0;
+        drained.numParameterChanges += event.type == Event::Type::parameterChange ? 1 : 0;
+    }
+
+    if (drained.numEvents == 0)
+        return;
+
+    const juce::ScopedLock sl(summaryLock);
+    summary.numEvents += drained.numEvents;
+    summary.numNotes += drained.numNotes;
+    summary.numParameterChanges += drained.numParameterChanges;
+}
+
+void PerformanceRecorder::writeSummary()
+{
+    const auto current = getSummary();
+
+    juce::String text;
+    text << "seconds: " << juce::String(current.seconds, 3) << "\n"
+         << "events: " << juce::String(current.numEvents) << "\n"
+         << "notes: " << juce::String(current.numNotes) << "\n"
+         << "parameter changes: " << juce::String(current.numParameterChanges) << "\n"
+         << "dropped events: " << juce::String(current.numDroppedEvents) << "\n"
+         << "dropped audio blocks: " << juce::String(current.numDroppedAudioBlocks) << "\n";
+
+    takeDirectory.getChildFile("summary.txt").replaceWithText(text);
+}
+
+//==============================================================================
+void PerformanceRecorder::bounceToMidiAsync(std::function<void(const juce::File&)> onFinished)
+{
+    jassert(!isRecording());
+
+    // The log is still being written while a take runs
+    if (isRecording())
+    {
+        if (onFinished != nullptr)
+            juce::MessageManager::callAsync([onFinished] { onFinished({}); });
+
+        return;
+    }
+
+    removeBounceJobs(false);
+
+    // The job keeps its own copy of the take's details, so a new take can start meanwhile
+    auto job = std::make_unique<BounceJob>();
+    job->directory = takeDirectory;
+    job->sampleRate = takeSampleRate;
+    job->instrument = takeInstrument;
+    job->onFinished = std::move(onFinished);
+
+    if (!writerThread.isThreadRunning())
+        writerThread.startThread();
+
+    writerThread.addTimeSliceClient(job.get());
+    bounceJobs.push_back(std::move(job));
+}
+
+int PerformanceRecorder::BounceJob::useTimeSlice()
+{
+    const auto file = bounceTake(directory, sampleRate, instrument);
+
+    if (onFinished != nullptr)
+        juce::MessageManager::callAsync([callback = onFinished, file] { callback(file); });
+
+    finished = true;
+    return -1;  // done: the thread drops this client
+}
+
+void PerformanceRecorder::removeBounceJobs(bool waitForUnfinished)
+{
+    for (auto it = bounceJobs.begin(); it != bounceJobs.end();)
+    {
+        auto& job = *it;
+
+        while (waitForUnfinished && !job->finished.load())
+            juce::Thread::sleep(5);
+
+        if (!job->finished.load())
+        {
+            ++it;
+            continue;
+        }
+
+        // Waits if the thread is still returning from the job's time slice
+        writerThread.removeTimeSliceClient(job.get());
+        it = bounceJobs.erase(it);
+    }
+}
+
+juce::File PerformanceRecorder::bounceTake(const juce::File& directory, double sampleRate, InstrumentType instrument)
+{
+    juce::FileInputStream log(getEventLogFile(directory));
+    if (log.failedToOpen())
+        return {};
+
+    std::vector<MidiExportEvent> midiEvents;
+    midiEvents.reserve(static_cast<size_t>(log.getTotalLength()) / sizeof(Event) * 2 + 16);
+
+    const double ticksPerSample = bounceBpm / 60.0 * MidiFileWriter::ticksPerQuarterNote / sampleRate;
+    std::array<std::bitset<128>, 2> held;
+    juce::uint32 tick = 0;
+
+    auto add = [&midiEvents, &tick] (int status, int data1, int data2)
+    {
+        midiEvents.push_back({ tick, static_cast<juce::uint8>(status), static_cast<juce::uint8>(data1), static_cast<juce::uint8>(data2) });
+    };
+
+    auto releaseChannel = [&] (int channel)
+    {
+        auto& notes = held[static_cast<size_t>(channel)];
+        for (int note = 0; note < 128; ++note)
+            if (notes[static_cast<size_t>(note)])
+                add(0x80 | channel, note, 0);
+
+        notes.reset();
+    };
+
+    Event event;
+    while (log.read(&event, sizeof(event)) == static_cast<int>(sizeof(event)))
+    {
+        tick = juce::jmax(tick, static_cast<juce::uint32>(juce::jmin(static_cast<double>(0x0fffffff),
+                                                                     std::round(event.samplePosition * ticksPerSample))));
+        const int channel = juce::jlimit(0, 1, static_cast<int>(event.channel));
+        auto& notes = held[static_cast<size_t>(channel)];
+
+        switch (event.type)
+        {
+            case Event::Type::noteOn:
+                // Bass notes are a single line; a repeated note restarts
+                if (channel == bassChannel)
+                    releaseChannel(channel);
+                else if (notes[event.note])
+                    add(0x80 | channel, event.note, 0);
+
+                add(0x90 | channel, event.note, event.velocity);
+                notes.set(event.note);
+                break;
+
+            case Event::Type::noteOff:
+                if (notes[event.note])
+                {
+                    add(0x80 | channel, event.note, 0);
+                    notes.reset(event.note);
+                }
+                break;
+
+            case Event::Type::allNotesOff:
+                releaseChannel(chordChannel);
+                releaseChannel(bassChannel);
+                break;
+
+            case Event::Type::parameterChange:
+                if (event.parameter == EngineParameter::instrument)
+                {
+                    const int index = juce::jlimit(0, numInstruments - 1, juce::roundToInt(event.value));
+                    add(0xc0 | chordChannel, getInstrument(static_cast<InstrumentType>(index)).midiProgram, 0);
+                }
+                break;
+        }
+    }
+
+    releaseChannel(chordChannel);
+    releaseChannel(bassChannel);
+
+    std::array<juce::uint8, 16> programs {};
+    programs[chordChannel] = getInstrument(instrument).midiProgram;
+    programs[bassChannel] = bassMidiProgram;
+
+    MidiFileWriter writer;
+    const auto& bytes = writer.writeEvents(directory.getFileName(), bounceBpm, midiEvents, programs);
+
+    const auto file = directory.getChildFile("performance.mid");
+    return file.replaceWithData(bytes.data(), bytes.size()) ? file : juce::File();
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "EngineCommandQueue.h"
+#include "InstrumentTable.h"
+
+//==============================================================================
+/*
+    Records a playing session: every note, chord and parameter change the
+    engine handles, and optionally the rendered audio. So far key clicks, fader
+    moves and inversion changes only went to std::cout.
+
+    On the audio thread, AudioEngine stamps each event with its sample position
+    and pushes it into a preallocated lock-free ring. Nothing there allocates or
+    locks. If the writer ever falls behind, events are dropped and counted
+    rather than stalling the callback.
+
+    A background TimeSliceThread drains the ring:
+      - events are appended to a binary log in the take's directory
+      - the take summary (counts, length, drops) is rewritten about once a
+        second
+      - with audio on, a juce::AudioFormatWriter::ThreadedWriter on the same
+        thread streams the output to a WAV file
+    Memory stays fixed however long the session runs.
+
+    After stop(), bounceToMidiAsync() turns the log into a MIDI file as a job
+    on the writer thread, reading the log back from disk, so neither playback
+    nor the UI pauses however long the take was:
+      - chord notes go on channel 1 and bass notes on channel 2
+      - velocities are the levels as heard, volume faders included
+      - chord triggers and all-notes-off become explicit note-offs
+      - instrument changes become program changes
+      - the file is at 120 bpm, so ticks map straight to time
+*/
+class PerformanceRecorder : private juce::TimeSliceClient
+{
+public:
+    static constexpr int chordChannel = 0;
+    static constexpr int bassChannel = 1;
+
+    struct Event
+    {
+        enum class Type : juce::uint8
+        {
+            noteOn,
+            noteOff,
+            allNotesOff,
+            parameterChange
+        };
+
+        juce::int64 samplePosition = 0;     // from the start of the take
+        Type type = Type::noteOn;
+        juce::uint8 channel = chordChannel;
+        juce::uint8 note = 0;
+        juce::uint8 velocity = 0;           // 1..127
+        EngineParameter parameter = EngineParameter::chordVolume;
+        float value = 0.0f;
+    };
+
+    struct Summary
+    {
+        juce::int64 numEvents = 0;
+        juce::int64 numNotes = 0;
+        juce::int64 numParameterChanges = 0;
+        juce::int64 numDroppedEvents = 0;
+        juce::int64 numDroppedAudioBlocks = 0;
+        double seconds = 0.0;
+    };
+
+    PerformanceRecorder();
+    ~PerformanceRecorder() override;
+
+    //==============================================================================
+    // Message thread
+
+    // Starts a take in directory. startSample is the engine's sample clock now.
+    bool start(const juce::File& directory, double sampleRate, int numChannels, bool withAudio,
+               InstrumentType instrument, juce::int64 startSample);
+
+    // Stops capturing and waits for the background thread to write everything out
+    void stop();
+
+    bool isRecording() const { return active.load(); }
+
+    // Writes the last take as a MIDI file in its directory on the writer thread, then
+    // calls onFinished (if any) on the message thread with the file, or {} on failure.
+    // The recorder's destructor waits for bounces still running.
+    void bounceToMidiAsync(std::function<void(const juce::File&)> onFinished);
+
+    juce::File getAudioFile() const { return takeDirectory.getChildFile("performance.wav"); }
+    Summary getSummary() const;
+
+    //==============================================================================
+    // Audio thread. Recording calls between beginBlock() and endBlock() are
+    // ignored unless a take is running.
+    void beginBlock();
+    void endBlock(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    void recordNoteOn(juce::int64 samplePosition, int channel, int midiNote, float velocity);
+    void recordNoteOff(juce::int64 samplePosition, int channel, int midiNote);
+    void recordAllNotesOff(juce::int64 samplePosition);
+    void recordParameter(juce::int64 samplePosition, EngineParameter parameter, float value);
+
+private:
+    int useTimeSlice() override;
+
+    void push(const Event& event);
+    void drainEvents();
+    void writeSummary();
+
+    static juce::File getEventLogFile(const juce::File& directory) { return directory.getChildFile("performance.events"); }
+    juce::File getEventLogFile() const { return getEventLogFile(takeDirectory); }
+
+    // Reads a finished take's event log and writes its MIDI file
+    static juce::File bounceTake(const juce::File& directory, double sampleRate, InstrumentType instrument);
+
+    // One bounce, run once by the writer thread
+    struct BounceJob : public juce::TimeSliceClient
+    {
+        juce::File directory;
+        double sampleRate = 44100.0;
+        InstrumentType instrument = InstrumentType::balafon;
+        std::function<void(const juce::File&)> onFinished;
+        std::atomic<bool> finished { false };
+
+        int useTimeSlice() override;
+    };
+
+    std::vector<std::unique_ptr<BounceJob>> bounceJobs;     // message thread only
+    void removeBounceJobs(bool waitForUnfinished);
+
+    LockFreeQueue<Event, 16384> events;
+
+    std::atomic<bool> active { false };
+    std::atomic<bool> audioThreadInside { false };
+    bool blockActive = false;                   // audio thread only
+
+    // Set by start() before the take goes active, then only read until stop()
+    juce::int64 takeStartSample = 0;
+    double takeSampleRate = 44100.0;
+    int takeNumChannels = 2;
+    InstrumentType takeInstrument = InstrumentType::balafon;
+    juce::File takeDirectory;
+
+    juce::TimeSliceThread writerThread { "Performance recorder" };
+    std::unique_ptr<juce::FileOutputStream> eventLog;
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> audioWriter;
+
+    std::atomic<juce::int64> numDroppedEvents { 0 };
+    std::atomic<juce::int64> numDroppedAudioBlocks { 0 };
+    std::atomic<juce::int64> numRecordedSamples { 0 };
+
+    mutable juce::CriticalSection summaryLock;  // never taken on the audio thread
+    Summary summary;
+    double lastSummaryWriteMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceRecorder)
+};
@@ -0,0 +1,144 @@
+#include "PluginProcessor.h"
+#include "RealtimeSafetyChecker.h"
+
+namespace
+{
+    namespace ParameterIDs
+    {
+        constexpr const char* instrument   = "instrument";
+        constexpr const char* sustain      = "sustain";
+        constexpr const char* releaseModel = "releaseModel";
+        constexpr const char* flam         = "flam";
+        constexpr const char* eqLow        = "eqLow";
+        constexpr const char* eqMid        = "eqMid";
+        constexpr const char* eqHigh       = "eqHigh";
+        constexpr const char* chordVolume  = "chordVolume";
+        constexpr const char* bassVolume   = "bassVolume";
+    }
+}
+
+PianoXLAudioProcessor::PianoXLAudioProcessor()
+    : AudioProcessor(BusesProperties().withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+      parameters(*this, nullptr, "PianoXL", createParameterLayout())
+{
+    const std::pair<EngineParameter, const char*> links[] = {
+        { EngineParameter::instrument,   ParameterIDs::instrument },
+        { EngineParameter::sustain,      ParameterIDs::sustain },
+        { EngineParameter::releaseModel, ParameterIDs::releaseModel },
+        { EngineParameter::flam,         ParameterIDs::flam },
+        { EngineParameter::eqLow,        ParameterIDs::eqLow },
+        { EngineParameter::eqMid,        ParameterIDs::eqMid },
+        { EngineParameter::eqHigh,       ParameterIDs::eqHigh },
+        { EngineParameter::chordVolume,  ParameterIDs::chordVolume },
+        { EngineParameter::bassVolume,   ParameterIDs::bassVolume }
+    };
+
+    static_assert(std::size(links) == std::tuple_size<decltype(parameterLinks)>::value, "one link per parameter");
+
+    for (size_t i = 0; i < parameterLinks.size(); ++i)
+    {
+        parameterLinks[i].parameter = links[i].first;
+        parameterLinks[i].value = parameters.getRawParameterValue(links[i].second);
+        jassert(parameterLinks[i].value != nullptr);
+    }
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout PianoXLAudioProcessor::createParameterLayout()
+{
+    juce::StringArray instruments;
+    for (const auto& instrument : instrumentTable)
+        instruments.add(instrument.label);
+
+    const auto gainRange = juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f);
+
+    // Ranges and defaults are the engine's (EngineParameter and AudioEngine::Parameters)
+    return {
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { ParameterIDs::instrument, 1 }, "Instrument",
+                                                     instruments, 0),
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::sustain, 1 }, "Sustain",
+                                                    juce::NormalisableRange<float>(10.0f, 200.0f, 1.0f), 100.0f,
+                                                    juce::AudioParameterFloatAttributes().withLabel("%")),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { ParameterIDs::releaseModel, 1 }, "Release",
+                                                     juce::StringArray { "Note-off", "Timed" }, 0),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { ParameterIDs::flam, 1 }, "Flam",
+                                                     juce::StringArray { "Off", "1/48", "1/32", "1/24", "1/16" }, 0),
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::eqLow, 1 }, "EQ Low", gainRange, 0.0f,
+                                                    juce::AudioParameterFloatAttributes().withLabel("dB")),
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::eqMid, 1 }, "EQ Mid", gainRange, 0.0f,
+                                                    juce::AudioParameterFloatAttributes().withLabel("dB")),
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::eqHigh, 1 }, "EQ High", gainRange, 0.0f,
+                                                    juce::AudioParameterFloatAttributes().withLabel("dB")),
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::chordVolume, 1 }, "Chord Volume",
+                                                    juce::NormalisableRange<float>(0.0f, 1.0f), 0.25f),
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::bassVolume, 1 }, "Bass Volume",
+                                                    juce::NormalisableRange<float>(0.0f, 1.0f), 0.75f)
+    };
+}
+
+PianoXLAudioProcessor::~PianoXLAudioProcessor()
+{
+}
+
+void PianoXLAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    engine.prepareToPlay(samplesPerBlock, sampleRate, getTotalNumOutputChannels());
+
+    // The engine starts from its defaults, so everything is applied again
+    for (auto& link : parameterLinks)
+        link.needsApplying = true;
+}
+
+void PianoXLAudioProcessor::releaseResources()
+{
+    engine.releaseResources();
+}
+
+bool PianoXLAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    const auto& output = layouts.getMainOutputChannelSet();
+    return output == juce::AudioChannelSet::mono() || output == juce::AudioChannelSet::stereo();
+}
+
+void PianoXLAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+
+    applyChangedParameters();
+
+    // The engine clears the buffer and places each MIDI event at its sample position
+    engine.processBlock(buffer, midiMessages);
+}
+
+void PianoXLAudioProcessor::applyChangedParameters()
+{
+    for (auto& link : parameterLinks)
+    {
+        const float value = link.value->load(std::memory_order_relaxed);
+
+        if (!link.needsApplying && value == link.lastApplied)
+            continue;
+
+        engine.setParameterFromAudioThread(link.parameter, value);
+        link.lastApplied = value;
+        link.needsApplying = false;
+    }
+}
+
+void PianoXLAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    if (auto xml = parameters.copyState().createXml())
+        copyXmlToBinary(*xml, destData);
+}
+
+void PianoXLAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    if (auto xml = getXmlFromBinary(data, sizeInBytes))
+        if (xml->hasTagName(parameters.state.getType()))
+            parameters.replaceState(juce::ValueTree::fromXml(*xml));
+}
+
+//==============================================================================
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new PianoXLAudioProcessor();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "AudioEngine.h"
+
+//==============================================================================
+/*
+    Headless instrument plugin around AudioEngine, built as VST3, LV2 and a
+    standalone app.
+
+    Host MIDI is rendered sample-accurately by AudioEngine::processBlock. In builds
+    with PIANOXL_REALTIME_CHECKS, every block runs inside a realtime section, so an
+    allocation or lock in the callback asserts (see RealtimeSafetyChecker).
+
+    The engine's settings are host parameters, kept in an AudioProcessorValueTreeState
+    and saved with the session. At the start of each block, the ones that changed are
+    applied to the engine before any of the block's MIDI is played. Host notes
+    keep their own velocity. The chord/bass volumes and flam shape the chords the
+    engine strikes itself, as in the preview app.
+*/
+class PianoXLAudioProcessor : public juce::AudioProcessor
+{
+public:
+    PianoXLAudioProcessor();
+    ~PianoXLAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    using AudioProcessor::processBlock;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    //==============================================================================
+    const juce::String getName() const override { return JucePlugin_Name; }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+
+    // Longest tail: a held note decays over 4 s at 200% sustain, then the 0.5 s release
+    double getTailLengthSeconds() const override { return 4.5; }
+
+    //==============================================================================
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    //==============================================================================
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+private:
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // Applies the parameters that changed since the last block
+    void applyChangedParameters();
+
+    AudioEngine engine;
+    juce::AudioProcessorValueTreeState parameters;
+
+    // A host parameter, the engine parameter it drives and the value last applied
+    struct EngineParameterLink
+    {
+        EngineParameter parameter = EngineParameter::chordVolume;
+        std::atomic<float>* value = nullptr;
+        float lastApplied = 0.0f;
+        bool needsApplying = true;
+    };
+
+    std::array<EngineParameterLink, 9> parameterLinks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoXLAudioProcessor)
+};
@@ -0,0 +1,136 @@
+#include "ProgressionSequencer.h"
+#include <climits>
+
+ProgressionSequencer::ProgressionSequencer()
+{
+}
+
+void ProgressionSequencer::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    stop();
+}
+
+void ProgressionSequencer::setTempo(double newBpm)
+{
+    const double oldBeat = getSamplesPerBeat();
+    bpm = juce::jlimit(20.0, 300.0, newBpm);
+
+    // Keep the current position within the beat and chord when the tempo changes mid-bar
+    if (playing && oldBeat > 0.0)
+    {
+        const double ratio = getSamplesPerBeat() / oldBeat;
+        samplesToNextBeat *= ratio;
+        samplesToNextChord *= ratio;
+    }
+}
+
+void ProgressionSequencer::setChord(int index, const juce::uint8* notes, int numNotes, int bassNote, double beats)
+{
+    if (!juce::isPositiveAndBelow(index, maxChords))
+        return;
+
+    auto& chord = chords[static_cast<size_t>(index)];
+    chord.numNotes = juce::jmin(numNotes, static_cast<int>(chord.notes.size()));
+    chord.bassNote = bassNote;
+    chord.beats = juce::jmax(0.25, beats);
+
+    for (int i = 0; i < chord.numNotes; ++i)
+        chord.notes[static_cast<size_t>(i)] = notes[i];
+}
+
+void ProgressionSequencer::setNumChords(int newNumChords)
+{
+    numChords = juce::jlimit(0, maxChords, newNumChords);
+}
+
+const ProgressionSequencer::Chord& ProgressionSequencer::getChord(int index) const
+{
+    jassert(juce::isPositiveAndBelow(index, maxChords));
+    return chords[static_cast<size_t>(juce::jlimit(0, maxChords - 1, index))];
+}
+
+void ProgressionSequencer::start()
+{
+    // The first step fires immediately, as playProgression() calls playStep() straight away
+    playing = true;
+    beatIndex = 0;
+    nextChord = 0;
+    samplesToNextBeat = 0.0;
+    samplesToNextChord = 0.0;
+}
+
+void ProgressionSequencer::stop()
+{
+    playing = false;
+    beatIndex = 0;
+    nextChord = 0;
+    samplesToNextBeat = 0.0;
+    samplesToNextChord = 0.0;
+}
+
+double ProgressionSequencer::getSamplesPerBeat() const
+{
+    return sampleRate * 60.0 / bpm;
+}
+
+int ProgressionSequencer::getSamplesUntilNextStep() const
+{
+    if (!playing)
+        return INT_MAX;
+
+    const double untilStep = numChords > 0 ? juce::jmin(samplesToNextBeat, samplesToNextChord) : samplesToNextBeat;
+    return juce::jmax(0, static_cast<int>(std::ceil(untilStep)));
+}
+
+void ProgressionSequencer::advance(int numSamples)
+{
+    if (playing)
+    {
+        samplesToNextBeat -= numSamples;
+        samplesToNextChord -= numSamples;
+    }
+}
+
+ProgressionSequencer::Step ProgressionSequencer::takeStep()
+{
+    jassert(isStepDue());
+
+    Step step;
+    const bool chordDue = numChords > 0 && samplesToNextChord <= 0.0;
+    bool beatDue = samplesToNextBeat <= 0.0;
+
+    if (chordDue)
+    {
+        // The progression may have been shortened while playing
+        if (nextChord >= numChords)
+            nextChord = 0;
+
+        // Each pass starts on the first click, even after chords of fractional length
+        if (nextChord == 0)
+        {
+            beatIndex = 0;
+            samplesToNextBeat = samplesToNextChord;
+            beatDue = true;
+        }
+
+        step.chordIndex = nextChord;
+        samplesToNextChord += chords[static_cast<size_t>(nextChord)].beats * getSamplesPerBeat();
+        nextChord = (nextChord + 1) % numChords;
+    }
+
+    step.stepIndex = beatIndex;
+
+    // With no chords loaded the clicks just keep counting bars. The fractional
+    // remainder is carried forward so steps never drift.
+    if (beatDue)
+    {
+        step.clickNumber = (beatIndex % 4) + 1;
+        if (++beatIndex >= 4 && numChords == 0)
+            beatIndex = 0;
+
+        samplesToNextBeat += getSamplesPerBeat();
+    }
+
+    return step;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "EngineCommandQueue.h"
+
+//==============================================================================
+/*
+    Audio-thread progression player, replacing the setTimeout chain in
+    playProgression() from audio-utils.ts.
+
+    Steps are counted against the sample clock. Beat and chord lengths are kept as
+    fractional numbers of samples, so rounding never accumulates into drift. The
+    engine asks how many samples remain until the next step, renders up to it, then
+    takes the step: a metronome click every beat, and a chord change whenever the
+    current chord's beats (ChordModifier.duration) are up. Chords needn't last a
+    whole number of beats; each pass through the progression starts on a click.
+*/
+class ProgressionSequencer
+{
+public:
+    static constexpr int maxChords = 64;
+
+    struct Chord
+    {
+        std::array<juce::uint8, EngineCommand::maxChordNotes> notes {};
+        int numNotes = 0;
+        int bassNote = -1;       // MIDI note, or -1 for none
+        double beats = 4.0;
+    };
+
+    struct Step
+    {
+        int stepIndex = 0;       // beat within the pass
+        int clickNumber = 0;     // 1..4, the voice click to play, or 0 between beats
+        int chordIndex = -1;     // chord to start on this step, or -1
+    };
+
+    ProgressionSequencer();
+
+    void prepare(double newSampleRate);
+
+    void setTempo(double newBpm);
+    double getTempo() const { return bpm; }
+
+    // beats is clamped to a 16th note at least
+    void setChord(int index, const juce::uint8* notes, int numNotes, int bassNote = -1, double beats = 4.0);
+    void setNumChords(int newNumChords);
+    int getNumChords() const { return numChords; }
+    const Chord& getChord(int index) const;
+
+    void start();
+    void stop();
+    bool isPlaying() const { return playing; }
+
+    // Samples to render before the next step is due, or INT_MAX when stopped
+    int getSamplesUntilNextStep() const;
+
+    // Moves the clock on by a rendered segment
+    void advance(int numSamples);
+
+    bool isStepDue() const { return playing && (samplesToNextBeat <= 0.0 || (numChords > 0 && samplesToNextChord <= 0.0)); }
+
+    // Consumes the due step and schedules the next one
+    Step takeStep();
+
+private:
+    double getSamplesPerBeat() const;
+
+    std::array<Chord, maxChords> chords;
+    int numChords = 0;
+
+    double sampleRate = 44100.0;
+    double bpm = 120.0;
+
+    bool playing = false;
+    int beatIndex = 0;
+    int nextChord = 0;
+    double samplesToNextBeat = 0.0;
+    double samplesToNextChord = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProgressionSequencer)
+};
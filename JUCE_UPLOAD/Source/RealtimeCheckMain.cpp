@@ -0,0 +1,199 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "RealtimeSafetyChecker.h"
+#include "MasterEQ.h"
+#include "MidiFileWriter.h"
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+/*
+    Headless run of the plugin's audio callback under RealtimeSafetyChecker.
+
+    Builds with PIANOXL_REALTIME_CHECKS always on, plays a few seconds of host
+    MIDI and parameter automation through PianoXLAudioProcessor::processBlock and
+    exits with 1 if anything in the callback allocated or locked. The MIDI and
+    parameter changes for each block are made before the call, outside the
+    realtime section, as a host would.
+
+    Checks stay off in the VST3/LV2 builds unless the CMake option asks for them;
+    this is the place to run them in CI.
+
+    It then times MasterEQ alone on 64-sample stereo blocks with every band
+    boosted or cut and reports the share of one core it takes; the target is under
+    1%. The figure is only printed, since debug builds and shared CI machines are
+    too noisy to fail on.
+
+    Last, MidiFileWriter's delta times are read back through juce::MidiFile at the
+    lengths where their variable-length encoding grows a byte; a mismatch also
+    exits with 1.
+*/
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numBlocks = static_cast<int>(8.0 * sampleRate / blockSize);
+
+    // A chord every half second, cycling the twelve roots, with the notes off just
+    // before the next one; an all-notes-off near the end
+    void fillMidiForBlock(int block, juce::MidiBuffer& midi)
+    {
+        constexpr int samplesPerChord = static_cast<int>(sampleRate / 2);
+        constexpr int majorTriad[] = { 0, 4, 7 };
+
+        const int blockStart = block * blockSize;
+
+        for (int offset = 0; offset < blockSize; ++offset)
+        {
+            const int sample = blockStart + offset;
+            const int chord = sample / samplesPerChord;
+            const int root = 48 + (chord * 7) % 12;
+
+            if (sample % samplesPerChord == 0)
+                for (auto interval : majorTriad)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, root + interval, static_cast<juce::uint8>(60 + chord % 60)), offset);
+
+            if (sample % samplesPerChord == samplesPerChord - blockSize)
+                for (auto interval : majorTriad)
+                    midi.addEvent(juce::MidiMessage::noteOff(1, root + interval), offset);
+        }
+
+        if (block == numBlocks - numBlocks / 8)
+            midi.addEvent(juce::MidiMessage::allNotesOff(1), 0);
+    }
+
+    // Percent of one core MasterEQ takes for a stereo stream in 64-sample blocks, with
+    // the bands away from flat so it isn't bypassed and one of them always moving
+    double measureMasterEQLoad()
+    {
+        constexpr int eqBlockSize = 64;
+        constexpr int numEqBlocks = static_cast<int>(20.0 * sampleRate / eqBlockSize);
+
+        MasterEQ eq;
+        eq.prepare(sampleRate, 2);
+        eq.setBandGain(MasterEQ::Band::low, 6.0f);
+        eq.setBandGain(MasterEQ::Band::mid, -4.0f);
+        eq.setBandGain(MasterEQ::Band::high, 3.0f);
+
+        juce::AudioBuffer<float> eqBuffer(2, eqBlockSize);
+        juce::Random random(1);
+
+        juce::int64 ticks = 0;
+
+        for (int block = 0; block < numEqBlocks; ++block)
+        {
+            for (int channel = 0; channel < eqBuffer.getNumChannels(); ++channel)
+                for (int i = 0; i < eqBlockSize; ++i)
+                    eqBuffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+            // A slow sweep on the high shelf keeps the coefficient interpolation in the measurement
+            if (block % 500 == 0)
+                eq.setBandGain(MasterEQ::Band::high, (block / 500) % 2 == 0 ? 3.0f : -3.0f);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            eq.process(eqBuffer, 0, eqBlockSize);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+        }
+
+        const double seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+        return 100.0 * seconds / (numEqBlocks * eqBlockSize / sampleRate);
+    }
+
+    // Notes lasting 127, 128, 16383 and 16384 ticks, either side of the one- and
+    // two-byte variable-length limits, written and read back with their lengths intact
+    bool checkMidiDeltaTimes()
+    {
+        constexpr juce::uint32 lengths[] = { 127, 128, 16383, 16384 };
+
+        std::vector<MidiExportEvent> events;
+        juce::uint32 tick = 0;
+
+        for (const auto length : lengths)
+        {
+            events.push_back({ tick, 0x90, 60, 100 });
+            events.push_back({ tick + length, 0x80, 60, 0 });
+            tick += length;
+        }
+
+        MidiFileWriter writer;
+        const auto& bytes = writer.writeEvents("Delta times", 120.0, events, {});
+
+        juce::MemoryInputStream stream(bytes.data(), bytes.size(), false);
+        juce::MidiFile file;
+
+        if (!file.readFrom(stream) || file.getNumTracks() != 2
+            || file.getTimeFormat() != MidiFileWriter::ticksPerQuarterNote)
+            return false;
+
+        std::vector<double> noteOns, noteOffs;
+        for (const auto* event : *file.getTrack(1))
+        {
+            if (event->message.isNoteOn())
+                noteOns.push_back(event->message.getTimeStamp());
+            else if (event->message.isNoteOff())
+                noteOffs.push_back(event->message.getTimeStamp());
+        }
+
+        if (noteOns.size() != std::size(lengths) || noteOffs.size() != std::size(lengths))
+            return false;
+
+        double expectedStart = 0.0;
+
+        for (size_t i = 0; i < std::size(lengths); ++i)
+        {
+            if (noteOns[i] != expectedStart || noteOffs[i] != expectedStart + lengths[i])
+                return false;
+
+            expectedStart += lengths[i];
+        }
+
+        return true;
+    }
+}
+
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    if (!RealtimeSafetyChecker::isEnabled())
+    {
+        std::cout << "PianoXLRealtimeCheck was built without PIANOXL_REALTIME_CHECKS" << std::endl;
+        return 1;
+    }
+
+    PianoXLAudioProcessor processor;
+    processor.setPlayConfigDetails(0, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    midi.ensureSize(4096);
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        // Host automation: every parameter moves a few times during the run
+        if (block % (numBlocks / 4) == numBlocks / 8)
+            for (auto* parameter : processor.getParameters())
+                parameter->setValueNotifyingHost(std::fmod(parameter->getValue() + 0.37f, 1.0f));
+
+        midi.clear();
+        fillMidiForBlock(block, midi);
+        processor.processBlock(buffer, midi);
+    }
+
+    processor.releaseResources();
+
+    const int numViolations = RealtimeSafetyChecker::getNumViolations();
+    std::cout << numBlocks << " blocks of " << blockSize << " samples, "
+              << numViolations << " real-time safety violations" << std::endl;
+
+    const double eqLoad = measureMasterEQLoad();
+    std::cout << "MasterEQ, stereo, 64-sample blocks: " << juce::String(eqLoad, 3) << "% of a core"
+              << (eqLoad < 1.0 ? "" : " (over the 1% target)") << std::endl;
+
+    const bool deltaTimesRoundTrip = checkMidiDeltaTimes();
+    std::cout << "MIDI delta times of 127/128/16383/16384 ticks: "
+              << (deltaTimesRoundTrip ? "read back intact" : "MISMATCH") << std::endl;
+
+    return numViolations > 0 || !deltaTimesRoundTrip ? 1 : 0;
+}
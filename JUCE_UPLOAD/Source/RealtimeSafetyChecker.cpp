@@ -0,0 +1,270 @@
+#include "RealtimeSafetyChecker.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+std::atomic<int> RealtimeSafetyChecker::numViolations { 0 };
+
+#if PIANOXL_REALTIME_CHECKS
+
+#if JUCE_LINUX
+ #include <pthread.h>
+
+// The real functions behind the --wrap=<symbol> link options set in CMakeLists.txt
+extern "C"
+{
+    void* __real_malloc(size_t);
+    void* __real_calloc(size_t, size_t);
+    void* __real_realloc(void*, size_t);
+    void __real_free(void*);
+    void* __real_aligned_alloc(size_t, size_t);
+    int __real_posix_memalign(void**, size_t, size_t);
+    int __real_pthread_mutex_lock(pthread_mutex_t*);
+}
+#endif
+
+namespace
+{
+    // Nesting depth of realtime sections on this thread
+    thread_local int realtimeDepth = 0;
+
+    // Allocate without going through the malloc check, so new isn't reported twice
+    void* allocateUnchecked(std::size_t size)
+    {
+       #if JUCE_LINUX
+        return __real_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void freeUnchecked(void* memory)
+    {
+       #if JUCE_LINUX
+        __real_free(memory);
+       #else
+        std::free(memory);
+       #endif
+    }
+
+    // For the std::align_val_t overloads. posix_memalign needs a multiple of sizeof(void*),
+    // and Windows has no aligned memory that free() can release.
+    void* allocateAlignedUnchecked(std::size_t size, std::align_val_t alignment)
+    {
+        const auto bytes = size == 0 ? 1 : size;
+        const auto align = juce::jmax(static_cast<std::size_t>(alignment), sizeof(void*));
+
+       #if JUCE_WINDOWS
+        return _aligned_malloc(bytes, align);
+       #else
+        void* memory = nullptr;
+        #if JUCE_LINUX
+         const int result = __real_posix_memalign(&memory, align, bytes);
+        #else
+         const int result = posix_memalign(&memory, align, bytes);
+        #endif
+        return result == 0 ? memory : nullptr;
+       #endif
+    }
+
+    void freeAlignedUnchecked(void* memory)
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(memory);
+       #else
+        freeUnchecked(memory);
+       #endif
+    }
+}
+
+void RealtimeSafetyChecker::enter()
+{
+    ++realtimeDepth;
+}
+
+void RealtimeSafetyChecker::exit()
+{
+    --realtimeDepth;
+}
+
+bool RealtimeSafetyChecker::isInsideRealtimeSection()
+{
+    return realtimeDepth > 0;
+}
+
+void RealtimeSafetyChecker::reportViolation(const char* what)
+{
+    // Reporting can allocate, so leave the section while doing it
+    const int depth = realtimeDepth;
+    realtimeDepth = 0;
+
+    ++numViolations;
+    std::fprintf(stderr, "Real-time safety violation inside the audio callback: %s\n", what);
+    jassertfalse;
+
+    realtimeDepth = depth;
+}
+
+//==============================================================================
+// Global operator new/delete. Replacements only reliably take effect in an
+// executable, i.e. the standalone and preview apps.
+void* operator new(std::size_t size)
+{
+    if (RealtimeSafetyChecker::isInsideRealtimeSection())
+        RealtimeSafetyChecker::reportViolation("operator new");
+
+    if (void* memory = allocateUnchecked(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    if (RealtimeSafetyChecker::isInsideRealtimeSection())
+        RealtimeSafetyChecker::reportViolation("operator new");
+
+    return allocateUnchecked(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory != nullptr && RealtimeSafetyChecker::isInsideRealtimeSection())
+        RealtimeSafetyChecker::reportViolation("operator delete");
+
+    freeUnchecked(memory);
+}
+
+void operator delete[](void* memory) noexcept                       { operator delete(memory); }
+void operator delete(void* memory, std::size_t) noexcept            { operator delete(memory); }
+void operator delete[](void* memory, std::size_t) noexcept          { operator delete(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept  { operator delete(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { operator delete(memory); }
+
+// Over-aligned types (alignas above the default new alignment) come through these
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (RealtimeSafetyChecker::isInsideRealtimeSection())
+        RealtimeSafetyChecker::reportViolation("aligned operator new");
+
+    if (void* memory = allocateAlignedUnchecked(size, alignment))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    if (RealtimeSafetyChecker::isInsideRealtimeSection())
+        RealtimeSafetyChecker::reportViolation("aligned operator new");
+
+    return allocateAlignedUnchecked(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    if (memory != nullptr && RealtimeSafetyChecker::isInsideRealtimeSection())
+        RealtimeSafetyChecker::reportViolation("aligned operator delete");
+
+    freeAlignedUnchecked(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept                               { operator delete(memory, alignment); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept                    { operator delete(memory, alignment); }
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept                  { operator delete(memory, alignment); }
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept          { operator delete(memory, alignment); }
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept        { operator delete(memory, alignment); }
+
+//==============================================================================
+// C allocation and mutex locking on Linux. CMakeLists.txt links with
+// --wrap=<symbol>, which routes every call made from this binary (including the
+// JUCE modules compiled into it) through these functions.
+#if JUCE_LINUX
+extern "C"
+{
+    void* __wrap_malloc(size_t size)
+    {
+        if (RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("malloc");
+
+        return __real_malloc(size);
+    }
+
+    void* __wrap_calloc(size_t count, size_t size)
+    {
+        if (RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("calloc");
+
+        return __real_calloc(count, size);
+    }
+
+    void* __wrap_realloc(void* memory, size_t size)
+    {
+        if (RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("realloc");
+
+        return __real_realloc(memory, size);
+    }
+
+    void __wrap_free(void* memory)
+    {
+        if (memory != nullptr && RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("free");
+
+        __real_free(memory);
+    }
+
+    void* __wrap_aligned_alloc(size_t alignment, size_t size)
+    {
+        if (RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("aligned_alloc");
+
+        return __real_aligned_alloc(alignment, size);
+    }
+
+    int __wrap_posix_memalign(void** memory, size_t alignment, size_t size)
+    {
+        if (RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("posix_memalign");
+
+        return __real_posix_memalign(memory, alignment, size);
+    }
+
+    int __wrap_pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        if (RealtimeSafetyChecker::isInsideRealtimeSection())
+            RealtimeSafetyChecker::reportViolation("pthread_mutex_lock");
+
+        return __real_pthread_mutex_lock(mutex);
+    }
+}
+#endif
+
+#else
+
+void RealtimeSafetyChecker::enter() {}
+void RealtimeSafetyChecker::exit() {}
+bool RealtimeSafetyChecker::isInsideRealtimeSection() { return false; }
+void RealtimeSafetyChecker::reportViolation(const char*) {}
+
+#endif
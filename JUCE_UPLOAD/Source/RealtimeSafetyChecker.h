@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Debug check that the audio callback stays real-time safe.
+
+    Put a ScopedRealtimeSection at the top of an audio callback. When the build
+    defines PIANOXL_REALTIME_CHECKS (Debug preview builds, PianoXLRealtimeCheck,
+    or any target with the CMake option), any heap allocation or release in that
+    scope trips an assertion and is counted, and so is any mutex lock on Linux.
+    Checks use a thread-local flag, so other threads can allocate freely.
+
+    Global operator new/delete are replaced on every platform, the
+    std::align_val_t forms included. On Linux the binary is also linked with
+    --wrap for malloc/calloc/realloc/free, aligned_alloc/posix_memalign and
+    pthread_mutex_lock, which catches juce::HeapBlock, std::mutex and
+    juce::CriticalSection in our code and in the JUCE modules built into it.
+    operator new replacements only reach the whole process in an executable, so
+    run the checks through PianoXLRealtimeCheck, the standalone or the preview app.
+
+    Without PIANOXL_REALTIME_CHECKS the section is an empty object and nothing is
+    replaced.
+*/
+class RealtimeSafetyChecker
+{
+public:
+    class ScopedRealtimeSection
+    {
+    public:
+       #if PIANOXL_REALTIME_CHECKS
+        ScopedRealtimeSection()     { enter(); }
+        ~ScopedRealtimeSection()    { exit(); }
+       #else
+        ScopedRealtimeSection() {}
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+
+    // Number of violations seen since startup (always 0 when checks are compiled out)
+    static int getNumViolations() { return numViolations.load(); }
+
+    static bool isEnabled()
+    {
+       #if PIANOXL_REALTIME_CHECKS
+        return true;
+       #else
+        return false;
+       #endif
+    }
+
+    // Called by the wrapped allocation and lock functions
+    static bool isInsideRealtimeSection();
+    static void reportViolation(const char* what);
+
+private:
+    static void enter();
+    static void exit();
+
+    static std::atomic<int> numViolations;
+};
@@ -0,0 +1,73 @@
+#include "RepaintBatcher.h"
+
+RepaintBatcher::RepaintBatcher(juce::Component& hostComponent)
+    : host(hostComponent),
+      vBlankAttachment(&hostComponent, [this]
+      {
+          if (onVBlank)
+              onVBlank();
+
+          flush();
+      })
+{
+}
+
+void RepaintBatcher::markDirty(juce::Component& component, juce::Rectangle<int> area)
+{
+    auto hostArea = &component == &host ? area : host.getLocalArea(&component, area);
+    hostArea = hostArea.getIntersection(host.getLocalBounds());
+
+    ++pendingRequests;
+
+    if (!hostArea.isEmpty())
+        dirty.add(hostArea);
+}
+
+void RepaintBatcher::markDirty(juce::Component& component)
+{
+    markDirty(component, component.getLocalBounds());
+}
+
+void RepaintBatcher::repaint(RepaintBatcher* batcher, juce::Component& component, juce::Rectangle<int> area)
+{
+    if (batcher != nullptr)
+        batcher->markDirty(component, area);
+    else
+        component.repaint(area);
+}
+
+void RepaintBatcher::repaint(RepaintBatcher* batcher, juce::Component& component)
+{
+    repaint(batcher, component, component.getLocalBounds());
+}
+
+void RepaintBatcher::flush()
+{
+    if (pendingRequests == 0)
+        return;
+
+    // RectangleList::add already keeps the list non-overlapping; this merges neighbours
+    dirty.consolidate();
+
+    juce::int64 pixels = 0;
+    for (const auto& area : dirty)
+    {
+        host.repaint(area);
+        pixels += static_cast<juce::int64>(area.getWidth()) * area.getHeight();
+    }
+
+    ++stats.numFlushes;
+    stats.numRequests += pendingRequests;
+    stats.numRectangles += dirty.getNumRectangles();
+    stats.numPixels += pixels;
+    stats.lastRequests = pendingRequests;
+    stats.lastRectangles = dirty.getNumRectangles();
+    stats.lastPixels = pixels;
+    stats.maxPixels = juce::jmax(stats.maxPixels, pixels);
+
+    dirty.clear();
+    pendingRequests = 0;
+
+    if (onFlush)
+        onFlush(stats);
+}
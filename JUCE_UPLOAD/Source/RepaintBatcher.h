@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+//==============================================================================
+/*
+    Collects the repaints of one window and issues them once per display
+    refresh.
+
+    A key or mode change, a chord press or a slot-label refresh touches many
+    keys and panel controls at once. Each of those used to call repaint() on
+    its own. Components now pass their dirty areas to markDirty() instead:
+      - areas are stored in the host's coordinates
+      - on the next vblank (juce::VBlankAttachment) the list is consolidated,
+        so overlapping and touching areas merge
+      - the host repaints each remaining rectangle, which redraws whichever
+        children lie under it
+    onVBlank runs just before each flush, so per-frame state such as the
+    sounding keys lands in the same pass as everything else.
+
+    A component with no batcher (the plugin editor, say) just calls
+    repaint(area) itself; see repaint() below.
+
+    Every flush is counted. A flush holds whatever one interaction changed,
+    since a click or key press never spans two frames. The counters give how
+    many repaint requests came in, how many rectangles and pixels went out, and
+    the pixels of the last and largest flush.
+*/
+class RepaintBatcher
+{
+public:
+    struct Stats
+    {
+        juce::int64 numFlushes = 0;
+        juce::int64 numRequests = 0;
+        juce::int64 numRectangles = 0;
+        juce::int64 numPixels = 0;
+
+        int lastRequests = 0;           // the most recent flush
+        int lastRectangles = 0;
+        juce::int64 lastPixels = 0;
+        juce::int64 maxPixels = 0;      // the largest single flush
+    };
+
+    explicit RepaintBatcher(juce::Component& hostComponent);
+
+    // Marks an area of component (in its own coordinates) for the next flush
+    void markDirty(juce::Component& component, juce::Rectangle<int> area);
+    void markDirty(juce::Component& component);
+
+    // Repaints through the batcher when there is one, or straight away otherwise
+    static void repaint(RepaintBatcher* batcher, juce::Component& component, juce::Rectangle<int> area);
+    static void repaint(RepaintBatcher* batcher, juce::Component& component);
+
+    // Issues the pending repaints now rather than at the next vblank
+    void flush();
+
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = {}; }
+
+    // Called on every vblank, before the flush
+    std::function<void()> onVBlank;
+
+    // Called after each flush that had requests
+    std::function<void(const Stats&)> onFlush;
+
+private:
+    juce::Component& host;
+    juce::RectangleList<int> dirty;
+    int pendingRequests = 0;
+    Stats stats;
+
+    juce::VBlankAttachment vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RepaintBatcher)
+};
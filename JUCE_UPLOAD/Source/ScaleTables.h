@@ -0,0 +1,154 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "ChordTable.h"
+
+//==============================================================================
+/*
+    Compile-time port of getScaleNotes() and getDiatonicChords() (chord-utils.ts).
+
+    The scale mask and the diatonic chord types for every key and MusicMode are
+    computed once by the compiler. A key or mode change is then a table lookup.
+    XOR-ing the old and new scale masks gives exactly the piano keys whose
+    highlight has to change.
+
+    Diatonic chord types for a root are stored as a bit set indexed by ChordType,
+    drawn from the same candidate list getDiatonicChords() tries.
+*/
+enum class MusicMode : juce::uint8
+{
+    free,
+    major,
+    minor,
+    dorian,
+    phrygian,
+    lydian,
+    mixolydian,
+    locrian
+};
+
+struct ModeDescriptor
+{
+    MusicMode mode;
+    const char* label;      // modeSelector text
+    juce::uint16 mask;      // pitch classes of the scale on C (modeIntervals)
+};
+
+inline constexpr std::array<ModeDescriptor, 8> modeTable
+{{
+    { MusicMode::free,       "FREE",       0b111111111111 },
+    { MusicMode::major,      "MAJOR",      0b101010110101 },   // 0 2 4 5 7 9 11
+    { MusicMode::minor,      "MINOR",      0b010110101101 },   // 0 2 3 5 7 8 10
+    { MusicMode::dorian,     "DORIAN",     0b011010101101 },   // 0 2 3 5 7 9 10
+    { MusicMode::phrygian,   "PHRYGIAN",   0b010110101011 },   // 0 1 3 5 7 8 10
+    { MusicMode::lydian,     "LYDIAN",     0b101011010101 },   // 0 2 4 6 7 9 11
+    { MusicMode::mixolydian, "MIXOLYDIAN", 0b011010110101 },   // 0 2 4 5 7 9 10
+    { MusicMode::locrian,    "LOCRIAN",    0b010101101011 }    // 0 1 3 5 6 8 10
+}};
+
+inline constexpr int numModes = static_cast<int>(modeTable.size());
+
+constexpr const ModeDescriptor& getMode(MusicMode mode)
+{
+    return modeTable[static_cast<size_t>(mode)];
+}
+
+// The table is indexed by the enum, so the two must stay in the same order
+constexpr bool modeTableMatchesEnum()
+{
+    for (size_t i = 0; i < modeTable.size(); ++i)
+        if (static_cast<size_t>(modeTable[i].mode) != i)
+            return false;
+    return true;
+}
+
+static_assert(modeTableMatchesEnum(), "modeTable must be in MusicMode order");
+
+//==============================================================================
+// Chord types getDiatonicChords() tries on each scale degree, in its order
+inline constexpr std::array<ChordType, 26> diatonicCandidateTypes
+{{
+    ChordType::major, ChordType::minor, ChordType::diminished, ChordType::augmented,
+    ChordType::dominant7, ChordType::major7, ChordType::minor7, ChordType::major9,
+    ChordType::minor9, ChordType::dominant9, ChordType::sus2, ChordType::sus4,
+    ChordType::add9, ChordType::minor7Flat5, ChordType::minor11, ChordType::diminished7,
+    ChordType::major6, ChordType::sixNine, ChordType::minor6, ChordType::minorMajor7,
+    ChordType::major11, ChordType::dominant13, ChordType::dominant7Sus4, ChordType::augmented7,
+    ChordType::augmentedMajor7, ChordType::dominant11
+}};
+
+// A set of chord types, one bit per ChordType
+using ChordTypeSet = juce::uint64;
+
+static_assert(numChordTypes <= 64, "ChordTypeSet needs a bit per chord type");
+
+constexpr ChordTypeSet toChordTypeSet(ChordType type)
+{
+    return ChordTypeSet(1) << static_cast<int>(type);
+}
+
+constexpr bool containsChordType(ChordTypeSet set, ChordType type)
+{
+    return (set & toChordTypeSet(type)) != 0;
+}
+
+struct ScaleInfo
+{
+    juce::uint16 mask = 0;                          // pitch classes in the scale
+    std::array<ChordTypeSet, 12> diatonicChords {};  // per root pitch class; empty off the scale
+};
+
+namespace ScaleTableHelpers
+{
+    constexpr ScaleInfo makeScale(int key, MusicMode mode)
+    {
+        ScaleInfo info;
+        info.mask = transposeMask(getMode(mode).mask, key);
+
+        for (int root = 0; root < 12; ++root)
+        {
+            if (!containsPitchClass(info.mask, root))
+                continue;
+
+            for (auto type : diatonicCandidateTypes)
+                if (isMaskSubsetOf(getChordMask(root, type), info.mask))
+                    info.diatonicChords[static_cast<size_t>(root)] |= toChordTypeSet(type);
+        }
+
+        return info;
+    }
+
+    constexpr std::array<ScaleInfo, 12 * 8> makeScaleTable()
+    {
+        std::array<ScaleInfo, 12 * 8> scales {};
+
+        for (int key = 0; key < 12; ++key)
+            for (int mode = 0; mode < numModes; ++mode)
+                scales[static_cast<size_t>(key * numModes + mode)] = makeScale(key, static_cast<MusicMode>(mode));
+
+        return scales;
+    }
+}
+
+inline constexpr auto scaleTable = ScaleTableHelpers::makeScaleTable();
+
+constexpr const ScaleInfo& getScale(int keyPitchClass, MusicMode mode)
+{
+    return scaleTable[static_cast<size_t>(getPitchClass(keyPitchClass) * numModes + static_cast<int>(mode))];
+}
+
+constexpr juce::uint16 getScaleMask(int keyPitchClass, MusicMode mode)
+{
+    return getScale(keyPitchClass, mode).mask;
+}
+
+constexpr ChordTypeSet getDiatonicChordTypes(int keyPitchClass, MusicMode mode, int rootPitchClass)
+{
+    return getScale(keyPitchClass, mode).diatonicChords[static_cast<size_t>(getPitchClass(rootPitchClass))];
+}
+
+static_assert(getScaleMask(7, MusicMode::major) == getScaleMask(0, MusicMode::lydian), "G major is C lydian");
+static_assert(containsChordType(getDiatonicChordTypes(0, MusicMode::major, 7), ChordType::dominant7), "G7 is diatonic to C major");
+static_assert(!containsChordType(getDiatonicChordTypes(0, MusicMode::major, 7), ChordType::major7), "Gmaj7 isn't");
+static_assert(getDiatonicChordTypes(0, MusicMode::major, 1) == 0, "C# isn't in C major");
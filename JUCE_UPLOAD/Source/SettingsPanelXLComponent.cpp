@@ -1,12 +1,30 @@
 #include "SettingsPanelXLComponent.h"
 #include <iostream>
+#include <algorithm>
 
 SettingsPanelXLComponent::SettingsPanelXLComponent()
 {
     // Set initial size
-    setSize(928, static_cast<int>(panelHeight));
+    setSize(1060, static_cast<int>(panelHeight));
 
     // Initialize buttons
+    // Record: click starts or stops a take, Shift+click toggles WAV capture
+    addAndMakeVisible(recordButton);
+    recordButton.setBackgroundColour(buttonColor);
+    recordButton.setBorderColour(buttonBorder);
+    setRecordAudio(recordAudio);
+    recordButton.onClick = [this]
+    {
+        if (juce::ModifierKeys::getCurrentModifiers().isShiftDown())
+        {
+            setRecordAudio(!recordAudio);
+            listeners.call([this](Listener& l) { l.recordAudioChanged(recordAudio); });
+            return;
+        }
+
+        listeners.call([](Listener& l) { l.recordButtonClicked(); });
+    };
+
     addAndMakeVisible(eyeButton);
     eyeButton.setBackgroundColour(buttonColor);
     eyeButton.setBorderColour(buttonBorder);
@@ -18,6 +36,7 @@ SettingsPanelXLComponent::SettingsPanelXLComponent()
     addAndMakeVisible(memoryButton);
     memoryButton.setBackgroundColour(buttonColor);
     memoryButton.setBorderColour(buttonBorder);
+    memoryButton.onClick = [this] { listeners.call([](Listener& l) { l.memoryButtonClicked(); }); };
 
     addAndMakeVisible(disableButton);
     disableButton.setBackgroundColour(buttonColor);
@@ -26,96 +45,151 @@ SettingsPanelXLComponent::SettingsPanelXLComponent()
     addAndMakeVisible(bassOffsetButton);
     bassOffsetButton.setBackgroundColour(buttonColor);
     bassOffsetButton.setBorderColour(buttonBorder);
+    bassOffsetButton.onClick = [this]
+    {
+        // Off, then bassOffsetRow's -2, +2, -3, +3, then off again
+        static constexpr int offsets[] = { 0, -2, 2, -3, 3 };
+        const auto current = std::find(std::begin(offsets), std::end(offsets), bassOffset);
+        const auto index = current == std::end(offsets) ? 0 : (current - std::begin(offsets) + 1) % std::size(offsets);
+
+        setBassOffset(offsets[index]);
+        listeners.call([this](Listener& l) { l.bassOffsetChanged(bassOffset); });
+    };
 
     // Initialize combo boxes with custom look and feel
     instrumentSelector.setLookAndFeel(&customLookAndFeel);
     addAndMakeVisible(instrumentSelector);
-    instrumentSelector.addItem("BALAFON", 1);
+    for (const auto& instrument : instrumentTable)
+        instrumentSelector.addItem(instrument.label, static_cast<int>(instrument.type) + 1);
     instrumentSelector.setSelectedId(1);
+    instrumentSelector.addListener(this);
 
     modeSelector.setLookAndFeel(&customLookAndFeel);
     addAndMakeVisible(modeSelector);
-    modeSelector.addItem("FREE", 1);
+    for (const auto& mode : modeTable)
+        modeSelector.addItem(mode.label, static_cast<int>(mode.mode) + 1);
     modeSelector.setSelectedId(1);
     modeSelector.addListener(this);
     modeSelector.getProperties().set("isSelected", false);
 
     // Initialize key labels
     addAndMakeVisible(keyLabel);
-    keyLabel.setText("KEY", juce::dontSendNotification);
+    keyLabel.setText("KEY");
     keyLabel.setFont(smallLabelFont);
-    keyLabel.setColour(juce::Label::textColourId, labelColor);
+    keyLabel.setTextColour(labelColor);
     keyLabel.setJustificationType(juce::Justification::centred);
 
     addAndMakeVisible(keyValueLabel);
-    keyValueLabel.setText("C", juce::dontSendNotification);
+    keyValueLabel.setText("C");
     keyValueLabel.setFont(displayFont);
-    keyValueLabel.setColour(juce::Label::textColourId, textColor);
+    keyValueLabel.setTextColour(textColor);
     keyValueLabel.setJustificationType(juce::Justification::centred);
 
     // Initialize octave labels
     addAndMakeVisible(octaveLabel);
-    octaveLabel.setText("OCT", juce::dontSendNotification);
+    octaveLabel.setText("OCT");
     octaveLabel.setFont(smallLabelFont);
-    octaveLabel.setColour(juce::Label::textColourId, labelColor);
+    octaveLabel.setTextColour(labelColor);
     octaveLabel.setJustificationType(juce::Justification::centred);
 
     addAndMakeVisible(octaveValueLabel);
-    octaveValueLabel.setText("0", juce::dontSendNotification);
+    octaveValueLabel.setText("0");
     octaveValueLabel.setFont(displayFont);
-    octaveValueLabel.setColour(juce::Label::textColourId, textColor);
+    octaveValueLabel.setTextColour(textColor);
     octaveValueLabel.setJustificationType(juce::Justification::centred);
 
     // Initialize inversion labels
     addAndMakeVisible(inversionLabel);
-    inversionLabel.setText("INV", juce::dontSendNotification);
+    inversionLabel.setText("INV");
     inversionLabel.setFont(smallLabelFont);
-    inversionLabel.setColour(juce::Label::textColourId, labelColor);
+    inversionLabel.setTextColour(labelColor);
     inversionLabel.setJustificationType(juce::Justification::centred);
 
     addAndMakeVisible(inversionValueLabel);
-    inversionValueLabel.setText("0", juce::dontSendNotification);
+    inversionValueLabel.setText("0");
     inversionValueLabel.setFont(displayFont);
-    inversionValueLabel.setColour(juce::Label::textColourId, textColor);
+    inversionValueLabel.setTextColour(textColor);
     inversionValueLabel.setJustificationType(juce::Justification::centred);
 
+    // Initialize flam labels
+    addAndMakeVisible(flamLabel);
+    flamLabel.setText("FLAM");
+    flamLabel.setFont(smallLabelFont);
+    flamLabel.setTextColour(labelColor);
+    flamLabel.setJustificationType(juce::Justification::centred);
+
+    addAndMakeVisible(flamValueLabel);
+    flamValueLabel.setText("OFF");
+    flamValueLabel.setFont(displayFont);
+    flamValueLabel.setTextColour(textColor);
+    flamValueLabel.setJustificationType(juce::Justification::centred);
+
+    // Initialize sustain labels
+    addAndMakeVisible(sustainLabel);
+    sustainLabel.setText("SUS");
+    sustainLabel.setFont(smallLabelFont);
+    sustainLabel.setTextColour(labelColor);
+    sustainLabel.setJustificationType(juce::Justification::centred);
+
+    addAndMakeVisible(sustainValueLabel);
+    sustainValueLabel.setText("100");
+    sustainValueLabel.setFont(displayFont);
+    sustainValueLabel.setTextColour(textColor);
+    sustainValueLabel.setJustificationType(juce::Justification::centred);
+
     // Initialize chord label
     addAndMakeVisible(chordLabel);
-    chordLabel.setText("CHORD", juce::dontSendNotification);
+    chordLabel.setText("CHORD");
     chordLabel.setFont(smallLabelFont);
-    chordLabel.setColour(juce::Label::textColourId, labelColor);
+    chordLabel.setTextColour(labelColor);
     chordLabel.setJustificationType(juce::Justification::centred);
 
     // Initialize chord display
     addAndMakeVisible(chordDisplay);
-    chordDisplay.setText("C#", juce::dontSendNotification);
+    chordDisplay.setText({});
     chordDisplay.setFont(chordDisplayFont);
-    chordDisplay.setColour(juce::Label::textColourId, textColor);
+    chordDisplay.setTextColour(textColor);
     chordDisplay.setJustificationType(juce::Justification::centred);
 
+    // Suggested next chords, small and grey so the chord being played stays the focus
+    addAndMakeVisible(suggestionDisplay);
+    suggestionDisplay.setText({});
+    suggestionDisplay.setFont(smallLabelFont);
+    suggestionDisplay.setTextColour(labelColor);
+    suggestionDisplay.setJustificationType(juce::Justification::centredLeft);
+    suggestionDisplay.setInterceptsMouseClicks(false, false);
+
     // Add mouse listeners for selectable labels
     createSelectableContainer(keyLabel, keyValueLabel, "key");
     createSelectableContainer(octaveLabel, octaveValueLabel, "octave");
     createSelectableContainer(inversionLabel, inversionValueLabel, "inversion");
+    createSelectableContainer(chordLabel, chordDisplay, "chord");
+    createSelectableContainer(sustainLabel, sustainValueLabel, "sustain");
+
+    // FLAM isn't selected for plus/minus: a click steps its value (see mouseDown)
+    createSelectableContainer(flamLabel, flamValueLabel, "flam");
 }
 
-void SettingsPanelXLComponent::createSelectableContainer(juce::Label& label, juce::Label& value, const juce::String& controlName)
+void SettingsPanelXLComponent::createSelectableContainer(PanelLabel& label, PanelLabel& value, const juce::String& controlName)
 {
     // Make both labels mouse-enabled
     label.setMouseCursor(juce::MouseCursor::PointingHandCursor);
     value.setMouseCursor(juce::MouseCursor::PointingHandCursor);
 
-    // Add click handlers
+    // Add click handlers. The labels take the clicks; the panel listens to them, and
+    // mouseDown tells them apart by event.eventComponent.
     label.setInterceptsMouseClicks(true, false);
     value.setInterceptsMouseClicks(true, false);
+    label.addMouseListener(this, false);
+    value.addMouseListener(this, false);
 
     // Store the control name in the label's name property for identification
     label.setName(controlName);
     value.setName(controlName);
 
     // Set initial colors
-    label.setColour(juce::Label::backgroundColourId, buttonColor);
-    value.setColour(juce::Label::backgroundColourId, buttonColor);
+    label.setBackgroundColour(buttonColor);
+    value.setBackgroundColour(buttonColor);
 }
 
 void SettingsPanelXLComponent::mouseDown(const juce::MouseEvent& event)
@@ -123,17 +197,36 @@ void SettingsPanelXLComponent::mouseDown(const juce::MouseEvent& event)
     auto* clickedComponent = event.eventComponent;
     
     // Check if we clicked on a label or its value
-    if (auto* label = dynamic_cast<juce::Label*>(clickedComponent))
+    if (auto* label = dynamic_cast<PanelLabel*>(clickedComponent))
     {
-        // Get the control name for the clicked label
+        // handleFlamCycle in InstrumentSelector.tsx, over the flams the engine has
+        if (label == &flamLabel || label == &flamValueLabel)
+        {
+            setFlam(static_cast<FlamValue>((static_cast<int>(flam) + 1) % (static_cast<int>(FlamValue::sixteenth) + 1)));
+            listeners.call([this](Listener& l) { l.flamChanged(flam); });
+            return;
+        }
+
+        // Shift+click on SUS switches the release model rather than selecting it
+        if ((label == &sustainLabel || label == &sustainValueLabel) && event.mods.isShiftDown())
+        {
+            setReleaseModel(releaseModel == EnvelopeBank::ReleaseModel::timed ? EnvelopeBank::ReleaseModel::noteOff
+                                                                              : EnvelopeBank::ReleaseModel::timed);
+            listeners.call([this](Listener& l) { l.releaseModelChanged(releaseModel); });
+            return;
+        }
+
+        // Get the control name for the clicked label (INV waits for mouseUp)
         juce::String controlName;
         
         if (label == &keyLabel || label == &keyValueLabel)
             controlName = "key";
         else if (label == &octaveLabel || label == &octaveValueLabel)
             controlName = "octave";
-        else if (label == &inversionLabel || label == &inversionValueLabel)
-            controlName = "inversion";
+        else if (label == &chordLabel || label == &chordDisplay)
+            controlName = "chord";
+        else if (label == &sustainLabel || label == &sustainValueLabel)
+            controlName = "sustain";
         
         if (controlName.isNotEmpty())
         {
@@ -142,6 +235,22 @@ void SettingsPanelXLComponent::mouseDown(const juce::MouseEvent& event)
     }
 }
 
+void SettingsPanelXLComponent::mouseUp(const juce::MouseEvent& event)
+{
+    // INV acts on release, once it's known whether the press was a long one
+    if (event.eventComponent != &inversionLabel && event.eventComponent != &inversionValueLabel)
+        return;
+
+    if (event.getLengthOfMousePress() >= longPressMs)
+    {
+        setVoiceLeading(!voiceLeading);
+        listeners.call([this](Listener& l) { l.voiceLeadingChanged(voiceLeading); });
+        return;
+    }
+
+    toggleSelection("inversion");
+}
+
 void SettingsPanelXLComponent::toggleSelection(const juce::String& control)
 {
     // If clicking the same control, deselect it
@@ -167,32 +276,21 @@ void SettingsPanelXLComponent::toggleSelection(const juce::String& control)
         }
     }
 
-    // Update visual state for labels
-    auto updateLabelPair = [this](juce::Label& label, juce::Label& value, const juce::String& controlName) {
-        bool isSelected = selectedControl == controlName;
-        
-        // Set background color
-        label.setColour(juce::Label::backgroundColourId, buttonColor);
-        value.setColour(juce::Label::backgroundColourId, buttonColor);
+    // Update visual state for labels. Each setter only marks a label when its value
+    // changes, so a selection change redraws just the pairs it selects and deselects.
+    auto updateLabelPair = [this](PanelLabel& label, PanelLabel& value, const juce::String& controlName) {
+        const bool isSelected = selectedControl == controlName;
 
-        // Set border color and thickness
-        if (isSelected)
-        {
-            label.setColour(juce::Label::outlineColourId, selectedBorder);
-            value.setColour(juce::Label::outlineColourId, selectedBorder);
-            label.setBorderSize(juce::BorderSize<int>(2));
-            value.setBorderSize(juce::BorderSize<int>(2));
-            
-            // Add hover effect for selected state
-            label.setColour(juce::Label::backgroundColourId, buttonColor.brighter(0.1f));
-            value.setColour(juce::Label::backgroundColourId, buttonColor.brighter(0.1f));
-        }
-        else
+        // Selected: a brighter (hover) background, a border and its outline
+        const auto background = isSelected ? buttonColor.brighter(0.1f) : buttonColor;
+        const auto outline = isSelected ? selectedBorder : juce::Colours::transparentBlack;
+        const juce::BorderSize<int> border(isSelected ? 2 : 0);
+
+        for (auto* pairLabel : { &label, &value })
         {
-            label.setColour(juce::Label::outlineColourId, juce::Colours::transparentBlack);
-            value.setColour(juce::Label::outlineColourId, juce::Colours::transparentBlack);
-            label.setBorderSize(juce::BorderSize<int>(0));
-            value.setBorderSize(juce::BorderSize<int>(0));
+            pairLabel->setBackgroundColour(background);
+            pairLabel->setOutlineColour(outline);
+            pairLabel->setBorderSize(border);
         }
     };
 
@@ -200,15 +298,36 @@ void SettingsPanelXLComponent::toggleSelection(const juce::String& control)
     updateLabelPair(keyLabel, keyValueLabel, "key");
     updateLabelPair(octaveLabel, octaveValueLabel, "octave");
     updateLabelPair(inversionLabel, inversionValueLabel, "inversion");
+    updateLabelPair(chordLabel, chordDisplay, "chord");
+    updateLabelPair(sustainLabel, sustainValueLabel, "sustain");
 
-    // Update mode selector
-    modeSelector.getProperties().set("isSelected", selectedControl == "mode");
-    modeSelector.repaint();
+    // Update mode selector. The labels mark themselves when their colours change and
+    // nothing the panel paints depends on the selection, so only the selector is marked.
+    const bool modeSelected = selectedControl == "mode";
+    if (static_cast<bool>(modeSelector.getProperties()["isSelected"]) != modeSelected)
+    {
+        modeSelector.getProperties().set("isSelected", modeSelected);
+        RepaintBatcher::repaint(repaintBatcher, modeSelector);
+    }
+
+    listeners.call([this](Listener& l) { l.selectedControlChanged(selectedControl); });
 
-    repaint();
     std::cout << "Selected control: " << (selectedControl.isEmpty() ? "none" : selectedControl) << std::endl;
 }
 
+void SettingsPanelXLComponent::setRepaintBatcher(RepaintBatcher* newBatcher)
+{
+    repaintBatcher = newBatcher;
+
+    for (auto* button : { &recordButton, &eyeButton, &skinButton, &memoryButton, &disableButton, &bassOffsetButton })
+        button->setRepaintBatcher(newBatcher);
+
+    for (auto* label : { &keyLabel, &keyValueLabel, &octaveLabel, &octaveValueLabel, &inversionLabel,
+                         &inversionValueLabel, &flamLabel, &flamValueLabel, &sustainLabel,
+                         &sustainValueLabel, &chordLabel, &chordDisplay, &suggestionDisplay })
+        label->setRepaintBatcher(newBatcher);
+}
+
 void SettingsPanelXLComponent::setSelectedControl(const juce::String& control)
 {
     toggleSelection(control);
@@ -219,7 +338,7 @@ void SettingsPanelXLComponent::setInversionValue(int newValue)
     if (currentInversionValue != newValue)
     {
         currentInversionValue = newValue;
-        inversionValueLabel.setText(juce::String(newValue), juce::dontSendNotification);
+        inversionValueLabel.setText(juce::String(newValue));
         
         // Broadcast value change if selected
         if (isInversionSelected)
@@ -229,17 +348,118 @@ void SettingsPanelXLComponent::setInversionValue(int newValue)
     }
 }
 
+void SettingsPanelXLComponent::setVoiceLeading(bool shouldLeadVoices)
+{
+    voiceLeading = shouldLeadVoices;
+    inversionLabel.setText(voiceLeading ? "INV VL" : "INV");
+}
+
 void SettingsPanelXLComponent::comboBoxChanged(juce::ComboBox* comboBoxThatHasChanged)
 {
     if (comboBoxThatHasChanged == &modeSelector)
     {
         toggleSelection("mode");
+
+        if (modeSelector.getSelectedId() > 0)
+        {
+            const auto mode = static_cast<MusicMode>(modeSelector.getSelectedId() - 1);
+            listeners.call([mode](Listener& l) { l.modeChanged(mode); });
+        }
     }
+    else if (comboBoxThatHasChanged == &instrumentSelector && instrumentSelector.getSelectedId() > 0)
+    {
+        const auto instrument = static_cast<InstrumentType>(instrumentSelector.getSelectedId() - 1);
+        listeners.call([instrument](Listener& l) { l.instrumentChanged(instrument); });
+    }
+}
+
+void SettingsPanelXLComponent::setInstrument(InstrumentType instrument)
+{
+    setSelectedIdBatched(instrumentSelector, static_cast<int>(instrument) + 1);
+}
+
+void SettingsPanelXLComponent::setSelectedIdBatched(juce::ComboBox& comboBox, int itemId)
+{
+    if (comboBox.getSelectedId() == itemId)
+        return;
+
+    // A ComboBox repaints its text itself; marking it as well keeps the batcher's pixel
+    // count complete, and the two requests for the same area merge in the peer
+    comboBox.setSelectedId(itemId, juce::dontSendNotification);
+    if (repaintBatcher != nullptr)
+        repaintBatcher->markDirty(comboBox);
+}
+
+void SettingsPanelXLComponent::setChordName(const juce::String& chordName)
+{
+    chordDisplay.setText(chordName);
+}
+
+void SettingsPanelXLComponent::setSuggestions(const juce::String& chordNames)
+{
+    suggestionDisplay.setText(chordNames);
+}
+
+void SettingsPanelXLComponent::setKey(int keyPitchClass)
+{
+    keyValueLabel.setText(pitchClassNames[static_cast<size_t>(getPitchClass(keyPitchClass))]);
+}
+
+void SettingsPanelXLComponent::setMode(MusicMode mode)
+{
+    setSelectedIdBatched(modeSelector, static_cast<int>(mode) + 1);
+}
+
+void SettingsPanelXLComponent::setRecording(bool isRecording)
+{
+    recordButton.setBorderColour(isRecording ? recordingBorder : buttonBorder);
+}
+
+void SettingsPanelXLComponent::setBassOffset(int semitones)
+{
+    if (bassOffset == semitones)
+        return;
+
+    bassOffset = semitones;
+
+    // The clef is painted by the panel, so its slot is repainted along with the border
+    bassOffsetButton.setBorderColour(bassOffset != 0 ? selectedBorder : buttonBorder);
+    RepaintBatcher::repaint(repaintBatcher, *this, bassOffsetButton.getBounds());
+}
+
+void SettingsPanelXLComponent::setFlam(FlamValue newFlam)
+{
+    flam = newFlam;
+    flamValueLabel.setText(getFlamName(flam));
+
+    // Outlined while a flam is on, as flamValueWindowActive
+    flamValueLabel.setOutlineColour(flam != FlamValue::off ? selectedBorder : juce::Colours::transparentBlack);
+}
+
+void SettingsPanelXLComponent::setSustain(int percent)
+{
+    sustainValueLabel.setText(juce::String(percent));
+}
+
+void SettingsPanelXLComponent::setReleaseModel(EnvelopeBank::ReleaseModel newModel)
+{
+    releaseModel = newModel;
+    sustainLabel.setText(releaseModel == EnvelopeBank::ReleaseModel::timed ? "TIMED" : "SUS");
+}
+
+void SettingsPanelXLComponent::setRecordAudio(bool shouldRecordAudio)
+{
+    recordAudio = shouldRecordAudio;
+
+    // A filled dot for events and audio, a ring for events only
+    recordButton.setIconText(recordAudio ? juce::String::fromUTF8("\xE2\x97\x8F") : juce::String::fromUTF8("\xE2\x97\x8B"),
+                             recordingBorder);
 }
 
 SettingsPanelXLComponent::~SettingsPanelXLComponent()
 {
     instrumentSelector.setLookAndFeel(nullptr);
+    instrumentSelector.removeListener(this);
     modeSelector.setLookAndFeel(nullptr);
     modeSelector.removeListener(this);
 }
@@ -261,7 +481,11 @@ void SettingsPanelXLComponent::paint(juce::Graphics& g)
     drawIcon(skinButton.getBounds().toFloat(), String::fromUTF8("\xE2\x86\x91"), textColor);
     drawIcon(memoryButton.getBounds().toFloat(), String::fromUTF8("\xF0\x9F\x96\xAB"), textColor);
     drawIcon(disableButton.getBounds().toFloat(), "X", juce::Colour::fromFloatRGBA(0.6f, 0.6f, 0.6f, 1.0f));
-    drawIcon(bassOffsetButton.getBounds().toFloat(), String::fromUTF8("\xF0\x9D\x84\xA2"), textColor);
+    // The clef, or the offset in use as in bassOffsetRow's "+2 BASS" labels
+    drawIcon(bassOffsetButton.getBounds().toFloat(),
+             bassOffset == 0 ? String::fromUTF8("\xF0\x9D\x84\xA2")
+                             : (bassOffset > 0 ? "+" : "") + juce::String(bassOffset),
+             textColor);
 }
 
 void SettingsPanelXLComponent::resized()
@@ -281,6 +505,14 @@ void SettingsPanelXLComponent::resized()
         x += circularButtonSize + padding;
     };
 
+    // The record button goes in the margin before the first slot
+    recordButton.setBounds(
+        static_cast<int>(padding),
+        static_cast<int>((panelHeight - circularButtonSize) / 2),
+        static_cast<int>(circularButtonSize),
+        static_cast<int>(circularButtonSize)
+    );
+
     layoutCircularButton(eyeButton);
     layoutCircularButton(skinButton);
     layoutCircularButton(memoryButton);
@@ -307,7 +539,7 @@ void SettingsPanelXLComponent::resized()
     const float totalHeight = labelHeight + valueHeight;
     const float labelY = (panelHeight - totalHeight) / 2;
 
-    auto layoutStackedLabels = [&](juce::Label& label, juce::Label& value, float width) {
+    auto layoutStackedLabels = [&](PanelLabel& label, PanelLabel& value, float width) {
         label.setBounds(
             static_cast<int>(x),
             static_cast<int>(labelY),
@@ -339,6 +571,11 @@ void SettingsPanelXLComponent::resized()
     layoutStackedLabels(octaveLabel, octaveValueLabel, numberWidth);
     layoutStackedLabels(inversionLabel, inversionValueLabel, numberWidth);
 
+    // FLAM and SUS, narrower than the number pairs; the panel is widened by their slots
+    const float narrowWidth = 55.0f;
+    layoutStackedLabels(flamLabel, flamValueLabel, narrowWidth);
+    layoutStackedLabels(sustainLabel, sustainValueLabel, narrowWidth);
+
     // Position chord label and display
     float chordLabelX = x - 20.0f; // Keep CHORD label at current position
     float chordDisplayX = x - 45.0f; // Move C# display further left by 25px
@@ -356,4 +593,13 @@ void SettingsPanelXLComponent::resized()
         static_cast<int>(numberWidth * 2),
         static_cast<int>(valueHeight)
     );
+
+    // Suggestions share the CHORD label's row, up to the panel's right edge
+    const float suggestionX = chordLabelX + numberWidth;
+    suggestionDisplay.setBounds(
+        static_cast<int>(suggestionX),
+        static_cast<int>(labelY),
+        juce::jmax(0, bounds.getRight() - static_cast<int>(suggestionX)),
+        static_cast<int>(labelHeight)
+    );
 } 
\ No newline at end of file
@@ -2,7 +2,13 @@
 
 #include <JuceHeader.h>
 #include "IconButton.h"
+#include "PanelLabel.h"
 #include "CustomLookAndFeel.h"
+#include "InstrumentTable.h"
+#include "ScaleTables.h"
+#include "RepaintBatcher.h"
+#include "StrumScheduler.h"
+#include "EnvelopeBank.h"
 
 class SettingsPanelXLComponent : public juce::Component,
                                 private juce::ComboBox::Listener
@@ -14,6 +20,16 @@ public:
     public:
         virtual ~Listener() = default;
         virtual void inversionSelectionChanged(bool isSelected, int value) = 0;
+        virtual void voiceLeadingChanged(bool /*shouldLeadVoices*/) {}
+        virtual void instrumentChanged(InstrumentType) {}
+        virtual void selectedControlChanged(const juce::String& /*control*/) {}
+        virtual void modeChanged(MusicMode) {}
+        virtual void recordButtonClicked() {}
+        virtual void memoryButtonClicked() {}
+        virtual void recordAudioChanged(bool /*shouldRecordAudio*/) {}
+        virtual void bassOffsetChanged(int /*semitones*/) {}
+        virtual void flamChanged(FlamValue) {}
+        virtual void releaseModelChanged(EnvelopeBank::ReleaseModel) {}
     };
 
     void addListener(Listener* l) { listeners.add(l); }
@@ -25,18 +41,58 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
     void mouseDown(const juce::MouseEvent& event) override;
+    void mouseUp(const juce::MouseEvent& event) override;
 
     // Add methods to handle button selection
     void setSelectedControl(const juce::String& control);
     juce::String getSelectedControl() const { return selectedControl; }
     void setInversionValue(int newValue);
 
+    // Whether chords move to the inversion nearest the last one (VoicingEngine). A long
+    // press on INV switches it, a short one selects INV as before; "INV VL" shows it's on.
+    void setVoiceLeading(bool shouldLeadVoices);
+    bool getVoiceLeading() const { return voiceLeading; }
+    void setInstrument(InstrumentType instrument);
+    void setChordName(const juce::String& chordName);
+    void setSuggestions(const juce::String& chordNames);
+    void setKey(int keyPitchClass);
+    void setMode(MusicMode mode);
+    void setRecording(bool isRecording);
+
+    // Whether takes capture a WAV as well as the event log (Shift+click on record)
+    void setRecordAudio(bool shouldRecordAudio);
+    bool getRecordAudio() const { return recordAudio; }
+
+    // Semitones the bass of the key slot last played is moved from its root: 0 or a
+    // bass-offset-config.ts value. The bass clef button steps through them.
+    void setBassOffset(int semitones);
+    int getBassOffset() const { return bassOffset; }
+
+    // Delay between strummed chord notes, shown in a FLAM window as in
+    // InstrumentSelector.tsx: a click steps Off, 1/48, 1/32, 1/24, 1/16, then off again
+    void setFlam(FlamValue newFlam);
+    FlamValue getFlam() const { return flam; }
+
+    // Sustain in percent (10-200), stepped with plus/minus while SUS is selected.
+    // Shift+click on SUS switches the release model: held notes end on key-up (SUS)
+    // or after sustain * 100 ms as the reference's unload timers do (TIMED).
+    void setSustain(int percent);
+    void setReleaseModel(EnvelopeBank::ReleaseModel newModel);
+    EnvelopeBank::ReleaseModel getReleaseModel() const { return releaseModel; }
+
+    // Collects the panel's repaints, its labels' and buttons' included, with the rest
+    // of the window's; null repaints directly
+    void setRepaintBatcher(RepaintBatcher* newBatcher);
+
 private:
     // ComboBox::Listener
     void comboBoxChanged(juce::ComboBox* comboBoxThatHasChanged) override;
 
     // Based on SettingsPanelXL.tsx styles
     const float panelHeight = 55.0f;
+
+    // Presses on INV held at least this long switch voice leading instead of selecting it
+    static constexpr int longPressMs = 500;
     const float cornerRadius = 8.8f;
     const juce::Colour backgroundColor = juce::Colours::transparentBlack;
     
@@ -46,27 +102,41 @@ private:
     const juce::Colour buttonColor = juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.5f);
     const juce::Colour buttonBorder = juce::Colour::fromFloatRGBA(0.5f, 0.5f, 0.5f, 0.5f);
     const juce::Colour selectedBorder = juce::Colour::fromFloatRGBA(0.4f, 0.4f, 0.4f, 0.8f);
+    const juce::Colour recordingBorder = juce::Colour::fromFloatRGBA(0.9f, 0.2f, 0.2f, 0.9f);
     
     // Track which control is currently selected
     juce::String selectedControl;
     bool isMusicModeSelected = false;
     bool isInversionSelected = false;
     int currentInversionValue = 0;
+    bool voiceLeading = false;
+    bool recordAudio = true;
+    int bassOffset = 0;
+    FlamValue flam = FlamValue::off;
+    EnvelopeBank::ReleaseModel releaseModel = EnvelopeBank::ReleaseModel::noteOff;
     juce::ListenerList<Listener> listeners;
+    RepaintBatcher* repaintBatcher = nullptr;
 
     // Helper method to create a selectable label container
-    void createSelectableContainer(juce::Label& label, juce::Label& value, const juce::String& controlName);
+    void createSelectableContainer(PanelLabel& label, PanelLabel& value, const juce::String& controlName);
     
+    // Selects a combo box item without notifying, counting its repaint with the batcher's
+    void setSelectedIdBatched(juce::ComboBox& comboBox, int itemId);
+
     // Helper method to toggle music mode
     void toggleMusicMode();
     
     // Helper method to toggle selection
     void toggleSelection(const juce::String& control);
     
+    // Starts/stops a take (PerformanceRecorder). Not in SettingsPanelXL.tsx, so it
+    // sits in the free space left of the eye button rather than taking a slot.
+    IconButton recordButton;
+
     // All buttons from left to right
     IconButton eyeButton;                // 1. Eye icon
     IconButton skinButton;               // 2. Skin icon
-    IconButton memoryButton;             // 3. Memory icon
+    IconButton memoryButton;             // 3. Memory icon: saves the progression library as MIDI files
     IconButton disableButton;            // 4. Disable icon
     IconButton bassOffsetButton;         // 5. Bass clef icon
     
@@ -77,18 +147,23 @@ private:
     juce::ComboBox instrumentSelector;    // 6. Instrument selector
     
     // Key display (7)
-    juce::Label keyLabel;                 // "KEY" text
-    juce::Label keyValueLabel;            // "C" value
+    PanelLabel keyLabel;                 // "KEY" text
+    PanelLabel keyValueLabel;            // "C" value
     
-    juce::ComboBox modeSelector;          // 8. Mode selector ("FREE")
+    juce::ComboBox modeSelector;          // 8. Mode selector (modeTable)
     
     // Number displays
-    juce::Label octaveLabel;              // "OCT" text
-    juce::Label octaveValueLabel;         // "0" value
-    juce::Label inversionLabel;           // "INV" text
-    juce::Label inversionValueLabel;      // "0" value
-    juce::Label chordLabel;               // "CHORD" text
-    juce::Label chordDisplay;             // "C#" value
+    PanelLabel octaveLabel;              // "OCT" text
+    PanelLabel octaveValueLabel;         // "0" value
+    PanelLabel inversionLabel;           // "INV" text
+    PanelLabel inversionValueLabel;      // "0" value
+    PanelLabel flamLabel;                // "FLAM" text
+    PanelLabel flamValueLabel;           // "OFF" or the flam's note value
+    PanelLabel sustainLabel;             // "SUS", or "TIMED" for the timed release
+    PanelLabel sustainValueLabel;        // "100" value
+    PanelLabel chordLabel;               // "CHORD" text
+    PanelLabel chordDisplay;             // Name of the chord being played
+    PanelLabel suggestionDisplay;        // Likely next chords, beside the CHORD label
     
     // Fonts and text properties
     const juce::Font displayFont { "Arial", 24.0f, juce::Font::plain };
@@ -0,0 +1,45 @@
+#include "SincInterpolator.h"
+
+SincInterpolator::SincInterpolator()
+{
+    const double pi = juce::MathConstants<double>::pi;
+    const double halfWidth = numTaps / 2.0;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        // Just under Nyquist at unity, halved for each doubling of the ratio
+        const double cutoff = 0.95 / static_cast<double>(1 << band);
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            const double fraction = static_cast<double>(phase) / numPhases;
+            auto& kernel = kernels[static_cast<size_t>(band)][static_cast<size_t>(phase)];
+            double sum = 0.0;
+
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                // Distance from this tap to the interpolation point, in source samples
+                const double t = static_cast<double>(tap - (numTaps / 2 - 1)) - fraction;
+                const double x = pi * cutoff * t;
+                const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(x) / x;
+                const double window = 0.42 + 0.5 * std::cos(pi * t / halfWidth)
+                                           + 0.08 * std::cos(2.0 * pi * t / halfWidth);
+
+                kernel[static_cast<size_t>(tap)] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+
+            // Unity gain at DC for every phase, so there's no ripple as the fraction moves
+            for (auto& coefficient : kernel)
+                coefficient = static_cast<float>(coefficient / sum);
+        }
+    }
+}
+
+int SincInterpolator::getBandForRatio(double ratio)
+{
+    if (ratio <= 1.0)
+        return 0;
+
+    return ratio <= 2.0 ? 1 : 2;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/*
+    Band-limited interpolation for repitching samples by arbitrary ratios.
+
+    The kernels are Blackman-windowed sincs, tabulated once at construction for
+    numPhases fractional offsets. Lookups interpolate linearly between adjacent
+    phases, so reading a sample never evaluates a sin(). Three tables cover
+    playback ratios up to 1, 2 and 4. For faster playback the cutoff is lowered so
+    the repitched signal doesn't alias.
+
+    The caller must keep numTaps / 2 readable samples on either side of every
+    position it asks for (pad the source with zeros).
+*/
+class SincInterpolator
+{
+public:
+    static constexpr int numTaps = 16;
+    static constexpr int numPhases = 256;
+    static constexpr int numBands = 3;
+
+    SincInterpolator();
+
+    // Picks the table for a playback ratio (source samples per output sample)
+    static int getBandForRatio(double ratio);
+
+    // Interpolates between source[0] and source[1] at fraction 0..1
+    float interpolate(const float* source, float fraction, int band) const
+    {
+        const float phasePosition = fraction * static_cast<float>(numPhases);
+        const int phase = juce::jmin(numPhases - 1, static_cast<int>(phasePosition));
+        const float blend = phasePosition - static_cast<float>(phase);
+
+        const float* lower = kernels[static_cast<size_t>(band)][static_cast<size_t>(phase)].data();
+        const float* upper = kernels[static_cast<size_t>(band)][static_cast<size_t>(phase + 1)].data();
+        const float* input = source - (numTaps / 2 - 1);
+
+        float sum = 0.0f;
+        for (int tap = 0; tap < numTaps; ++tap)
+            sum += input[tap] * (lower[tap] + blend * (upper[tap] - lower[tap]));
+
+        return sum;
+    }
+
+private:
+    using Kernel = std::array<float, numTaps>;
+
+    // numPhases + 1 rows, so the last phase can blend towards the next whole sample
+    std::array<std::array<Kernel, numPhases + 1>, numBands> kernels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SincInterpolator)
+};
@@ -0,0 +1,36 @@
+#include "SoundResources.h"
+
+#if PIANOXL_HAS_BINARY_SOUNDS
+ #include "PianoXLSounds.h"
+#endif
+
+std::unique_ptr<juce::InputStream> SoundResources::open(const juce::String& folder, const juce::String& fileName)
+{
+   #if PIANOXL_HAS_BINARY_SOUNDS
+    // Resources are named after their files, so look them up by the original name
+    for (int i = 0; i < PianoXLSounds::namedResourceListSize; ++i)
+    {
+        if (fileName != PianoXLSounds::originalFilenames[i])
+            continue;
+
+        int size = 0;
+        if (const auto* data = PianoXLSounds::getNamedResource(PianoXLSounds::namedResourceList[i], size))
+            return std::make_unique<juce::MemoryInputStream>(data, static_cast<size_t>(size), false);
+    }
+   #endif
+
+    const auto binaryDirectory = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory();
+
+    for (const auto& resources : { binaryDirectory.getChildFile("Resources"),
+                                   binaryDirectory.getSiblingFile("Resources"),
+                                   juce::File::getCurrentWorkingDirectory().getChildFile("Resources") })
+    {
+        const auto file = resources.getChildFile(folder).getChildFile(fileName);
+
+        if (file.existsAsFile())
+            if (auto stream = file.createInputStream())
+                return stream;
+    }
+
+    return nullptr;
+}
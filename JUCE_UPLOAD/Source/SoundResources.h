@@ -0,0 +1,26 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+
+//==============================================================================
+/*
+    Finds the sample files the engine decodes at startup, the way the reference
+    loads them with require() from its assets folder.
+
+    When the build found the files in Resources/, CMake compiles them into the
+    PianoXLSounds binary data (PIANOXL_HAS_BINARY_SOUNDS). They are then read
+    from memory, wherever the app or plugin happens to run from.
+    Otherwise Resources/<folder>/<fileName> is searched for next to the
+    executable (or plugin binary), in a macOS bundle's Contents/Resources, and
+    last under the working directory.
+*/
+class SoundResources
+{
+public:
+    // A stream over the file, or null if it isn't in any of those places
+    static std::unique_ptr<juce::InputStream> open(const juce::String& folder, const juce::String& fileName);
+
+private:
+    SoundResources() = delete;
+};
@@ -0,0 +1,91 @@
+#include "StrumScheduler.h"
+#include <climits>
+
+void StrumScheduler::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    clear();
+}
+
+double StrumScheduler::getSamplesBetweenNotes() const
+{
+    double division = 0.0;
+
+    switch (flam)
+    {
+        case FlamValue::fortyEighth:   division = 48.0; break;
+        case FlamValue::thirtySecond:  division = 32.0; break;
+        case FlamValue::twentyFourth:  division = 24.0; break;
+        case FlamValue::sixteenth:     division = 16.0; break;
+        case FlamValue::off:           return 0.0;
+    }
+
+    // A whole note is four beats; the reference plays flams at half time, hence * 2
+    const double samplesPerWholeNote = 4.0 * 60.0 / bpm * sampleRate;
+    return samplesPerWholeNote / division * 2.0;
+}
+
+void StrumScheduler::schedule(int midiNote, float velocity, int delayInSamples)
+{
+    if (numPending >= maxPendingNotes)
+        return;
+
+    auto& note = pending[static_cast<size_t>(numPending++)];
+    note.midiNote = midiNote;
+    note.velocity = velocity;
+    note.samplesRemaining = juce::jmax(0, delayInSamples);
+}
+
+void StrumScheduler::cancel(int midiNote)
+{
+    int kept = 0;
+    for (int i = 0; i < numPending; ++i)
+        if (pending[static_cast<size_t>(i)].midiNote != midiNote)
+            pending[static_cast<size_t>(kept++)] = pending[static_cast<size_t>(i)];
+
+    numPending = kept;
+}
+
+int StrumScheduler::getSamplesUntilNextNote() const
+{
+    int earliest = INT_MAX;
+    for (int i = 0; i < numPending; ++i)
+        earliest = juce::jmin(earliest, pending[static_cast<size_t>(i)].samplesRemaining);
+    return earliest;
+}
+
+void StrumScheduler::advance(int numSamples)
+{
+    for (int i = 0; i < numPending; ++i)
+    {
+        auto& note = pending[static_cast<size_t>(i)];
+        note.samplesRemaining = juce::jmax(0, note.samplesRemaining - numSamples);
+    }
+}
+
+bool StrumScheduler::isNoteDue() const
+{
+    return numPending > 0 && getSamplesUntilNextNote() == 0;
+}
+
+StrumScheduler::PendingNote StrumScheduler::takeDueNote()
+{
+    jassert(isNoteDue());
+
+    // Notes are scheduled in strum order, so take the first due one to keep that order
+    for (int i = 0; i < numPending; ++i)
+    {
+        if (pending[static_cast<size_t>(i)].samplesRemaining == 0)
+        {
+            const auto note = pending[static_cast<size_t>(i)];
+
+            for (int j = i + 1; j < numPending; ++j)
+                pending[static_cast<size_t>(j - 1)] = pending[static_cast<size_t>(j)];
+
+            --numPending;
+            return note;
+        }
+    }
+
+    return {};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Flam settings from FlamValue in music.ts
+enum class FlamValue : juce::uint8
+{
+    off,
+    fortyEighth,   // 1/48
+    thirtySecond,  // 1/32
+    twentyFourth,  // 1/24
+    sixteenth      // 1/16
+};
+
+// The flam as InstrumentSelector.tsx's flamOptions name it
+inline const char* getFlamName(FlamValue flam)
+{
+    static constexpr const char* names[] = { "OFF", "1/48", "1/32", "1/24", "1/16" };
+    return names[static_cast<size_t>(flam)];
+}
+
+//==============================================================================
+/*
+    Per-note start offsets for strummed chords.
+
+    getFlamDelay() in audio-utils.ts delays each chord note by index * flam with
+    setTimeout. Here every note gets an offset in samples instead. The engine renders
+    up to the next pending start, then starts the note. Offsets that reach past the
+    end of the block simply carry over into the next one, so no timers or threads
+    are involved.
+*/
+class StrumScheduler
+{
+public:
+    static constexpr int maxPendingNotes = 32;
+
+    struct PendingNote
+    {
+        int midiNote = 0;
+        float velocity = 0.0f;
+        int samplesRemaining = 0;
+    };
+
+    void prepare(double newSampleRate);
+
+    void setFlam(FlamValue newFlam)    { flam = newFlam; }
+    void setTempo(double newBpm)       { bpm = juce::jlimit(20.0, 300.0, newBpm); }
+
+    // Delay between consecutive chord notes, in samples (0 when flam is off)
+    double getSamplesBetweenNotes() const;
+
+    // Queues a note to start after the given delay
+    void schedule(int midiNote, float velocity, int delayInSamples);
+
+    // Drops every pending start, e.g. when a new chord replaces the current one
+    void clear() { numPending = 0; }
+
+    // Drops the pending starts of one note, e.g. when its key is let go mid-strum
+    void cancel(int midiNote);
+
+    // Samples to render before the next note is due, or INT_MAX when nothing is pending
+    int getSamplesUntilNextNote() const;
+
+    void advance(int numSamples);
+
+    bool isNoteDue() const;
+
+    // Removes and returns the earliest due note
+    PendingNote takeDueNote();
+
+private:
+    std::array<PendingNote, maxPendingNotes> pending;
+    int numPending = 0;
+
+    double sampleRate = 44100.0;
+    double bpm = 120.0;
+    FlamValue flam = FlamValue::off;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StrumScheduler)
+};
@@ -0,0 +1,136 @@
+#include "VoicePool.h"
+#include "OscillatorKernels.h"
+
+VoicePool::VoicePool()
+{
+    monoBuffer.setSize(1, 512);
+}
+
+void VoicePool::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    monoBuffer.setSize(1, maximumBlockSize);
+    envelopes.prepare(sampleRate, maximumBlockSize);
+
+    for (auto& voice : voices)
+        voice = SynthVoice();
+}
+
+void VoicePool::setSustain(float sustainPercent)
+{
+    envelopes.setSustain(sustainPercent);
+}
+
+int VoicePool::findVoiceToStart(int midiNote) const
+{
+    // Retrigger the same note in place so repeated taps don't stack up
+    for (int i = 0; i < maxVoices; ++i)
+        if (isVoiceActive(i) && voices[static_cast<size_t>(i)].midiNote == midiNote)
+            return i;
+
+    for (int i = 0; i < maxVoices; ++i)
+        if (!isVoiceActive(i))
+            return i;
+
+    // Steal: oldest released voice first, otherwise the oldest held voice
+    int oldestReleased = -1;
+    int oldestHeld = -1;
+
+    for (int i = 0; i < maxVoices; ++i)
+    {
+        int& oldest = envelopes.isReleasing(i) ? oldestReleased : oldestHeld;
+        if (oldest < 0 || voices[static_cast<size_t>(i)].age < voices[static_cast<size_t>(oldest)].age)
+            oldest = i;
+    }
+
+    return oldestReleased >= 0 ? oldestReleased : oldestHeld;
+}
+
+void VoicePool::noteOn(int midiNote, float velocity)
+{
+    const int index = findVoiceToStart(midiNote);
+    auto& voice = voices[static_cast<size_t>(index)];
+
+    voice.midiNote = midiNote;
+    voice.velocity = velocity;
+    voice.phaseIncrement = juce::MidiMessage::getMidiNoteInHertz(midiNote) / sampleRate;
+    voice.instrument = currentInstrument;
+    voice.age = nextAge++;
+
+    envelopes.start(index, initialGain * velocity);
+}
+
+void VoicePool::noteOff(int midiNote)
+{
+    for (int i = 0; i < maxVoices; ++i)
+        if (isVoiceActive(i) && voices[static_cast<size_t>(i)].midiNote == midiNote)
+            envelopes.release(i);
+}
+
+void VoicePool::allNotesOff()
+{
+    for (int i = 0; i < maxVoices; ++i)
+        envelopes.release(i);
+}
+
+void VoicePool::render(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // Hosts may send more than the expected block size; split rather than reallocate
+    while (numSamples > 0)
+    {
+        const int chunk = juce::jmin(numSamples, monoBuffer.getNumSamples());
+        renderChunk(buffer, startSample, chunk);
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+}
+
+void VoicePool::renderChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (envelopes.getNumActive() == 0)
+        return;
+
+    monoBuffer.clear(0, 0, numSamples);
+    auto* mono = monoBuffer.getWritePointer(0);
+
+    envelopes.process(numSamples);
+
+    for (int index = 0; index < maxVoices; ++index)
+    {
+        // Voices that were silent for the whole chunk have nothing to render
+        const int audible = envelopes.getAudibleSamples(index);
+        if (audible == 0)
+            continue;
+
+        auto& voice = voices[static_cast<size_t>(index)];
+
+        // The instrument is resolved once per voice here, not per sample
+        const auto renderVoice = OscillatorKernels::renderFunctions[static_cast<size_t>(voice.instrument)];
+        renderVoice(voice.phase, voice.phaseIncrement, envelopes.getGains(index), mono, audible);
+
+        if (!isVoiceActive(index))
+            voice.midiNote = -1;
+    }
+
+    // Voices are mono: add the sum into every output channel
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        buffer.addFrom(channel, startSample, monoBuffer, 0, 0, numSamples);
+}
+
+int VoicePool::getNumActiveVoices() const
+{
+    return envelopes.getNumActive();
+}
+
+void VoicePool::getSoundingNotes(std::array<juce::uint64, 2>& notes) const
+{
+    notes = {};
+
+    for (int i = 0; i < maxVoices; ++i)
+    {
+        const int note = voices[static_cast<size_t>(i)].midiNote;
+
+        if (isVoiceActive(i) && !envelopes.isReleasing(i) && note >= 0 && note < 128)
+            notes[static_cast<size_t>(note >> 6)] |= juce::uint64 { 1 } << (note & 63);
+    }
+}
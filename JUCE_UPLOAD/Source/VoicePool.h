@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "EnvelopeBank.h"
+#include "InstrumentTable.h"
+
+// One sounding note. Voices live in a fixed array inside VoicePool and are recycled,
+// replacing the per-press oscillator/gain node pairs created by playNote/playChord
+// in audio-utils.ts.
+struct SynthVoice
+{
+    int midiNote = -1;
+    float velocity = 0.0f;
+
+    double phase = 0.0;          // 0..1
+    double phaseIncrement = 0.0; // cycles per sample
+
+    // Chosen when the note starts, so switching instruments doesn't change sounding notes
+    InstrumentType instrument = InstrumentType::balafon;
+
+    // The amplitude envelope lives in the pool's EnvelopeBank, in the slot with this voice's index
+
+    juce::uint32 age = 0;        // start order, used for voice stealing
+};
+
+//==============================================================================
+/*
+    Fixed-size voice pool for the audio thread.
+
+    All storage is allocated up front, so starting, stopping and rendering notes never
+    touches the heap or takes a lock. When every voice is busy the oldest released
+    voice is stolen first, then the oldest held one.
+
+    Envelopes for all voices are computed together by an EnvelopeBank. A voice is
+    free from the sample its envelope falls silent, and the oscillator only runs
+    for the audible part of the block.
+*/
+class VoicePool
+{
+public:
+    static constexpr int maxVoices = 32;
+
+    VoicePool();
+
+    void prepare(double newSampleRate, int maximumBlockSize);
+
+    // Sustain in percent (10-200), as in setSustain() from audio-utils.ts
+    void setSustain(float sustainPercent);
+    void setReleaseModel(EnvelopeBank::ReleaseModel newModel)   { envelopes.setReleaseModel(newModel); }
+
+    // Instrument for notes started from now on
+    void setInstrument(InstrumentType newInstrument)            { currentInstrument = newInstrument; }
+
+    void noteOn(int midiNote, float velocity);
+    void noteOff(int midiNote);
+    void allNotesOff();
+
+    // Adds the active voices into the given region of the buffer
+    void render(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    int getNumActiveVoices() const;
+
+    // Sets bit n of the 128-bit mask for every note started and not yet released
+    void getSoundingNotes(std::array<juce::uint64, 2>& notes) const;
+
+private:
+    int findVoiceToStart(int midiNote) const;
+    bool isVoiceActive(int index) const     { return envelopes.isActive(index); }
+    void renderChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    static_assert(maxVoices <= EnvelopeBank::maxVoices, "every voice needs an envelope slot");
+
+    std::array<SynthVoice, maxVoices> voices;
+    EnvelopeBank envelopes;
+    juce::AudioBuffer<float> monoBuffer;
+    double sampleRate = 44100.0;
+    juce::uint32 nextAge = 0;
+    InstrumentType currentInstrument = InstrumentType::balafon;
+
+    // Initial gain from playChord (0.5)
+    static constexpr float initialGain = 0.5f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoicePool)
+};
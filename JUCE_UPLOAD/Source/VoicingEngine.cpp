@@ -0,0 +1,159 @@
+#include "VoicingEngine.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr int middleC = 60;   // MIDDLE_C from chord-utils.ts
+
+    int getVoicingIndex(int rootPitchClass, ChordType type, int inversionIndex)
+    {
+        return (static_cast<int>(type) * 12 + getPitchClass(rootPitchClass)) * VoicingEngine::numInversions
+             + juce::jlimit(-VoicingEngine::maxInversion, VoicingEngine::maxInversion, inversionIndex) + VoicingEngine::maxInversion;
+    }
+
+    // Distance from each note of one chord to the nearest note of the other
+    int getDistanceToNearest(const ChordNotes& notes, const ChordNotes& targets)
+    {
+        int total = 0;
+
+        for (auto note : notes)
+        {
+            int nearest = 128;
+            for (auto target : targets)
+                nearest = juce::jmin(nearest, std::abs(static_cast<int>(note) - static_cast<int>(target)));
+
+            total += nearest;
+        }
+
+        return total;
+    }
+}
+
+//==============================================================================
+VoicingEngine::VoicingEngine()
+{
+    for (const auto& chord : chordTable)
+        for (int rootPitchClass = 0; rootPitchClass < 12; ++rootPitchClass)
+        {
+            const auto rootPosition = buildChord(middleC + rootPitchClass, chord.type);
+
+            for (int inversionIndex = -maxInversion; inversionIndex <= maxInversion; ++inversionIndex)
+                voicings[static_cast<size_t>(getVoicingIndex(rootPitchClass, chord.type, inversionIndex))]
+                    = invert(rootPosition, inversionIndex);
+        }
+}
+
+void VoicingEngine::setInversion(int newInversion)
+{
+    inversion = juce::jlimit(-maxInversion, maxInversion, newInversion);
+}
+
+void VoicingEngine::setVoiceLeading(bool shouldLeadVoices)
+{
+    voiceLeading = shouldLeadVoices;
+}
+
+void VoicingEngine::reset()
+{
+    previous = {};
+}
+
+const ChordNotes& VoicingEngine::getVoicing(int rootPitchClass, ChordType type, int inversionIndex) const
+{
+    return voicings[static_cast<size_t>(getVoicingIndex(rootPitchClass, type, inversionIndex))];
+}
+
+ChordNotes VoicingEngine::voice(int rootMidiNote, ChordType type)
+{
+    const int rootPitchClass = getPitchClass(rootMidiNote);
+    const int octaveOffset = rootMidiNote - (middleC + rootPitchClass);
+
+    auto best = transpose(getVoicing(rootPitchClass, type, inversion), octaveOffset);
+
+    if (voiceLeading && previous.size() > 0)
+    {
+        int bestMovement = getMovement(previous, best);
+        int bestDistance = 0;
+
+        for (int inversionIndex = -maxInversion; inversionIndex <= maxInversion; ++inversionIndex)
+        {
+            for (int octaveShift = -1; octaveShift <= 1; ++octaveShift)
+            {
+                const auto candidate = transpose(getVoicing(rootPitchClass, type, inversionIndex), octaveOffset + 12 * octaveShift);
+                if (candidate.size() == 0)
+                    continue;
+
+                // On a tie, stay closest to the INV setting and the requested octave
+                const int movement = getMovement(previous, candidate);
+                const int distance = std::abs(inversionIndex - inversion) + std::abs(octaveShift);
+
+                if (movement < bestMovement || (movement == bestMovement && distance < bestDistance))
+                {
+                    best = candidate;
+                    bestMovement = movement;
+                    bestDistance = distance;
+                }
+            }
+        }
+    }
+
+    if (best.size() > 0)
+        previous = best;
+
+    return best;
+}
+
+//==============================================================================
+ChordNotes VoicingEngine::invert(const ChordNotes& chord, int inversionIndex)
+{
+    std::array<int, ChordDescriptor::maxIntervals> notes {};
+    const int numNotes = chord.size();
+
+    for (int i = 0; i < numNotes; ++i)
+        notes[static_cast<size_t>(i)] = chord.notes[static_cast<size_t>(i)];
+
+    if (numNotes > 0)
+    {
+        // handleKeyPress: raise the lowest note and rotate it to the top, or
+        // lower the highest note and rotate it to the bottom
+        for (int step = 0; step < std::abs(inversionIndex); ++step)
+        {
+            if (inversionIndex > 0)
+            {
+                notes[0] += 12;
+                std::rotate(notes.begin(), notes.begin() + 1, notes.begin() + numNotes);
+            }
+            else
+            {
+                notes[static_cast<size_t>(numNotes - 1)] -= 12;
+                std::rotate(notes.begin(), notes.begin() + numNotes - 1, notes.begin() + numNotes);
+            }
+        }
+    }
+
+    ChordNotes result;
+    for (int i = 0; i < numNotes; ++i)
+        if (juce::isPositiveAndBelow(notes[static_cast<size_t>(i)], 128))
+            result.notes[static_cast<size_t>(result.numNotes++)] = static_cast<juce::uint8>(notes[static_cast<size_t>(i)]);
+
+    return result;
+}
+
+ChordNotes VoicingEngine::transpose(const ChordNotes& chord, int semitones)
+{
+    ChordNotes result;
+
+    for (auto note : chord)
+    {
+        const int transposed = note + semitones;
+        if (juce::isPositiveAndBelow(transposed, 128))
+            result.notes[static_cast<size_t>(result.numNotes++)] = static_cast<juce::uint8>(transposed);
+    }
+
+    return result;
+}
+
+int VoicingEngine::getMovement(const ChordNotes& from, const ChordNotes& to)
+{
+    return getDistanceToNearest(to, from) + getDistanceToNearest(from, to);
+}
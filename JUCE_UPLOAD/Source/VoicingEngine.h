@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "ChordTable.h"
+
+//==============================================================================
+/*
+    Turns a chord and the INV setting into MIDI notes, as handleKeyPress() does
+    in PianoXL.tsx. A positive inversion moves the lowest note up an octave once
+    per step, and a negative one moves the highest note down.
+
+    Every voicing (chord type x root pitch class x inversion -5..+5) is built once
+    in the constructor for roots in the middle-C octave. Voicing a chord is a
+    lookup plus an octave offset, so plus/minus presses never allocate.
+
+    With voice leading on, the INV setting is only a starting point. Each chord
+    takes whichever cached inversion, moved by up to an octave either way, gives
+    the least total movement from the previous chord. Movement counts the
+    distance from each note to the nearest note of the other chord, in both
+    directions, so chords of different sizes still compare.
+*/
+class VoicingEngine
+{
+public:
+    static constexpr int maxInversion = 5;
+    static constexpr int numInversions = 2 * maxInversion + 1;
+
+    VoicingEngine();
+
+    void setInversion(int newInversion);
+    int getInversion() const { return inversion; }
+
+    void setVoiceLeading(bool shouldLeadVoices);
+    bool isVoiceLeading() const { return voiceLeading; }
+
+    // Voices a chord on rootMidiNote and remembers it for voice leading
+    ChordNotes voice(int rootMidiNote, ChordType type);
+
+    // Cached voicing with the root in the middle-C octave
+    const ChordNotes& getVoicing(int rootPitchClass, ChordType type, int inversionIndex) const;
+
+    // Forgets the previous chord, so the next one uses the INV setting as is
+    void reset();
+
+private:
+    static ChordNotes invert(const ChordNotes& chord, int inversionIndex);
+    static ChordNotes transpose(const ChordNotes& chord, int semitones);
+    static int getMovement(const ChordNotes& from, const ChordNotes& to);
+
+    std::array<ChordNotes, static_cast<size_t>(numChordTypes * 12 * numInversions)> voicings;
+
+    int inversion = 0;
+    bool voiceLeading = false;
+    ChordNotes previous;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoicingEngine)
+};